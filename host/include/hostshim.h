@@ -0,0 +1,240 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		hostshim.h
+
+	Abstract:
+
+		Host side controls of the shim: simulated time, pool accounting,
+		registry values, captured HID reports, a simulated FTS controller
+		behind the SPB interface and a device tying it all together the
+		way OnPrepareHardware and OnInterruptIsr do
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#pragma once
+
+#include <wdm.h>
+#include <wdf.h>
+#include <spbhelper.h>
+#include <report.h>
+#include <fts\ftsinternal.h>
+#include <fts\ftsregs.h>
+#include <fts\ftsevents.h>
+#include <fts\ftspointer.h>
+
+//
+// Interrupt time, in 100ns units. It follows the monotonic clock of the
+// host until HostClockSet freezes it, it then only moves with
+// HostClockAdvance and KeDelayExecutionThread.
+//
+VOID
+HostClockSet(
+	IN ULONG64 Time
+);
+
+VOID
+HostClockAdvance(
+	IN ULONG64 Delta
+);
+
+//
+// Pool accounting, counts every ExAllocatePoolWithTag since start
+//
+LONG
+HostPoolAllocations(
+	VOID
+);
+
+LONG
+HostPoolOutstanding(
+	VOID
+);
+
+//
+// Registry values answered to RtlQueryRegistryValues
+//
+VOID
+HostRegistrySetValue(
+	IN PCWSTR Path,
+	IN PCWSTR Name,
+	IN ULONG Value
+);
+
+VOID
+HostRegistryClear(
+	VOID
+);
+
+//
+// Framework objects that only the driver entry points create
+//
+NTSTATUS
+HostDeviceObjectCreate(
+	OUT WDFDEVICE* Device
+);
+
+NTSTATUS
+HostQueueCreate(
+	IN WDFDEVICE Device,
+	OUT WDFQUEUE* Queue
+);
+
+//
+// Read requests pending on a queue and the reports they completed with
+//
+typedef struct _HOST_REPORT
+{
+	HID_INPUT_REPORT Report;
+	ULONG ContactsPerReport;
+	ULONG64 Timestamp;
+} HOST_REPORT;
+
+VOID
+HostQueuePostReads(
+	IN WDFQUEUE Queue,
+	IN ULONG Count
+);
+
+ULONG
+HostQueuePendingReads(
+	IN WDFQUEUE Queue
+);
+
+VOID
+HostQueueCompleteRead(
+	IN WDFREQUEST Request,
+	IN PHID_INPUT_REPORT Report,
+	IN ULONG ContactsPerReport
+);
+
+ULONG
+HostQueueReportCount(
+	IN WDFQUEUE Queue
+);
+
+const HOST_REPORT*
+HostQueueReport(
+	IN WDFQUEUE Queue,
+	IN ULONG Index
+);
+
+VOID
+HostQueueClearReports(
+	IN WDFQUEUE Queue
+);
+
+//
+// Timers only fire through HostTimerFire, DueTime receives the
+// interrupt time the timer is due at
+//
+BOOLEAN
+HostTimerQueued(
+	IN WDFTIMER Timer,
+	OUT ULONG64* DueTime
+);
+
+BOOLEAN
+HostTimerFire(
+	IN WDFTIMER Timer
+);
+
+//
+// Simulated FTS controller. Events pushed while the FIFO is full are
+// lost, as on the chip. Reads pop events and stamp the first one with
+// the number of events left, saturated like the real count.
+//
+typedef struct _HOST_FTS_CHIP
+{
+	FTS_CHIP_FAMILY ChipFamily;
+
+	BYTE Fifo[FIFO_DEPTH][FIFO_EVENT_SIZE];
+	ULONG FifoHead;
+	ULONG FifoCount;
+	ULONG LostEvents;
+
+	//
+	// Number of the read to fail, counting from one, zero for none. The
+	// events the read would have returned are lost.
+	//
+	ULONG FailRead;
+
+	//
+	// Bus activity
+	//
+	ULONG Reads;
+	ULONG Writes;
+	ULONG BytesRead;
+	ULONG BytesWritten;
+	ULONG InterruptEnableWrites;
+	ULONG Flushes;
+
+	BOOLEAN AsyncPending;
+	NTSTATUS AsyncStatus;
+} HOST_FTS_CHIP;
+
+VOID
+HostFtsChipInitialize(
+	OUT HOST_FTS_CHIP* Chip,
+	IN FTS_CHIP_FAMILY ChipFamily
+);
+
+BOOLEAN
+HostFtsChipPushEvent(
+	IN HOST_FTS_CHIP* Chip,
+	IN const BYTE* Event
+);
+
+VOID
+HostFtsBuildPointerEvent(
+	OUT BYTE* Event,
+	IN BYTE EventId,
+	IN BYTE TouchId,
+	IN USHORT X,
+	IN USHORT Y,
+	IN UCHAR Pressure,
+	IN UCHAR Size
+);
+
+//
+// A device as set up by OnPrepareHardware, the screen properties come
+// from the registry values set beforehand
+//
+typedef struct _HOST_DEVICE
+{
+	WDFDEVICE FxDevice;
+	HOST_FTS_CHIP Chip;
+	SPB_CONTEXT I2CContext;
+	FTS_CONTROLLER_CONTEXT* TouchContext;
+	REPORT_CONTEXT ReportContext;
+} HOST_DEVICE;
+
+NTSTATUS
+HostDeviceCreate(
+	OUT HOST_DEVICE* Device,
+	IN FTS_CHIP_FAMILY ChipFamily
+);
+
+VOID
+HostDeviceDestroy(
+	IN HOST_DEVICE* Device
+);
+
+NTSTATUS
+HostDeviceInterrupt(
+	IN HOST_DEVICE* Device
+);
+
+VOID
+HostDeviceRead(
+	IN HOST_DEVICE* Device,
+	IN ULONG Count
+);
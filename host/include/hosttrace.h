@@ -0,0 +1,31 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		hosttrace.h
+
+	Abstract:
+
+		Stands in for the WPP generated *.tmh headers in the host build,
+		where traces are compiled out
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#pragma once
+
+#define TRACE_LEVEL_NONE        0
+#define TRACE_LEVEL_CRITICAL    1
+#define TRACE_LEVEL_ERROR       2
+#define TRACE_LEVEL_WARNING     3
+#define TRACE_LEVEL_INFORMATION 4
+#define TRACE_LEVEL_VERBOSE     5
+
+#define Trace(LEVEL, FLAGS, MSG, ...) ((void)0)
+#define TraceHot(LEVEL, FLAGS, MSG, ...) ((void)0)
@@ -0,0 +1,21 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		reshub.h
+
+	Abstract:
+
+		Empty in the host build, the event pipeline does not use any of
+		the resource hub definitions
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#pragma once
@@ -0,0 +1,195 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		wdf.h
+
+	Abstract:
+
+		Host replacement for the framework objects used by the event
+		pipeline. Objects are plain heap allocations deleted with their
+		parent, locks are mutexes, timers only fire when the host asks
+		for it and queues complete reads into a capture buffer.
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#pragma once
+
+#include <wdm.h>
+
+typedef struct _HOST_WDF_OBJECT* WDFOBJECT;
+typedef struct _HOST_WDF_OBJECT* WDFDEVICE;
+typedef struct _HOST_WDF_OBJECT* WDFTIMER;
+typedef struct _HOST_WDF_OBJECT* WDFSPINLOCK;
+typedef struct _HOST_WDF_OBJECT* WDFWAITLOCK;
+typedef struct _HOST_WDF_OBJECT* WDFQUEUE;
+typedef struct _HOST_WDF_OBJECT* WDFREQUEST;
+typedef struct _HOST_WDF_OBJECT* WDFIOTARGET;
+typedef struct _HOST_WDF_OBJECT* WDFMEMORY;
+typedef struct _HOST_WDF_OBJECT* WDFINTERRUPT;
+typedef struct _HOST_WDF_OBJECT* WDFWORKITEM;
+
+typedef enum _WDF_TRI_STATE
+{
+	WdfFalse = FALSE,
+	WdfTrue = TRUE,
+	WdfUseDefault = 2,
+} WDF_TRI_STATE;
+
+//
+// Object attributes and typed contexts
+//
+typedef struct _WDF_OBJECT_CONTEXT_TYPE_INFO
+{
+	const char* ContextName;
+	SIZE_T ContextSize;
+} WDF_OBJECT_CONTEXT_TYPE_INFO;
+
+typedef struct _WDF_OBJECT_ATTRIBUTES
+{
+	ULONG Size;
+	WDFOBJECT ParentObject;
+	SIZE_T ContextSizeOverride;
+	const WDF_OBJECT_CONTEXT_TYPE_INFO* ContextTypeInfo;
+} WDF_OBJECT_ATTRIBUTES, * PWDF_OBJECT_ATTRIBUTES;
+
+#define WDF_NO_OBJECT_ATTRIBUTES NULL
+
+static inline VOID
+WDF_OBJECT_ATTRIBUTES_INIT(
+	PWDF_OBJECT_ATTRIBUTES Attributes
+)
+{
+	RtlZeroMemory(Attributes, sizeof(WDF_OBJECT_ATTRIBUTES));
+	Attributes->Size = sizeof(WDF_OBJECT_ATTRIBUTES);
+}
+
+#define WDF_GET_CONTEXT_TYPE_INFO(type) (&WDF_##type##_TYPE_INFO)
+
+#define WDF_OBJECT_ATTRIBUTES_INIT_CONTEXT_TYPE(attributes, type) \
+	do { \
+		WDF_OBJECT_ATTRIBUTES_INIT(attributes); \
+		(attributes)->ContextTypeInfo = WDF_GET_CONTEXT_TYPE_INFO(type); \
+	} while (0)
+
+PVOID
+HostWdfObjectGetContext(
+	IN WDFOBJECT Object
+);
+
+#define WDF_DECLARE_CONTEXT_TYPE_WITH_NAME(type, casting) \
+	static const WDF_OBJECT_CONTEXT_TYPE_INFO WDF_##type##_TYPE_INFO = \
+		{ #type, sizeof(type) }; \
+	static inline type* casting(WDFOBJECT Handle) \
+	{ \
+		return (type*)HostWdfObjectGetContext(Handle); \
+	}
+
+VOID
+WdfObjectDelete(
+	IN WDFOBJECT Object
+);
+
+//
+// Locks
+//
+NTSTATUS
+WdfSpinLockCreate(
+	IN PWDF_OBJECT_ATTRIBUTES SpinLockAttributes,
+	OUT WDFSPINLOCK* SpinLock
+);
+
+VOID
+WdfSpinLockAcquire(
+	IN WDFSPINLOCK SpinLock
+);
+
+VOID
+WdfSpinLockRelease(
+	IN WDFSPINLOCK SpinLock
+);
+
+NTSTATUS
+WdfWaitLockCreate(
+	IN PWDF_OBJECT_ATTRIBUTES LockAttributes,
+	OUT WDFWAITLOCK* Lock
+);
+
+NTSTATUS
+WdfWaitLockAcquire(
+	IN WDFWAITLOCK Lock,
+	IN PLONGLONG Timeout
+);
+
+VOID
+WdfWaitLockRelease(
+	IN WDFWAITLOCK Lock
+);
+
+//
+// Timers
+//
+typedef VOID
+EVT_WDF_TIMER(
+	IN WDFTIMER Timer
+);
+
+typedef EVT_WDF_TIMER* PFN_WDF_TIMER;
+
+typedef struct _WDF_TIMER_CONFIG
+{
+	ULONG Size;
+	PFN_WDF_TIMER EvtTimerFunc;
+	ULONG Period;
+	BOOLEAN AutomaticSerialization;
+	ULONG TolerableDelay;
+	WDF_TRI_STATE UseHighResolutionTimer;
+} WDF_TIMER_CONFIG, * PWDF_TIMER_CONFIG;
+
+static inline VOID
+WDF_TIMER_CONFIG_INIT(
+	PWDF_TIMER_CONFIG Config,
+	PFN_WDF_TIMER EvtTimerFunc
+)
+{
+	RtlZeroMemory(Config, sizeof(WDF_TIMER_CONFIG));
+	Config->Size = sizeof(WDF_TIMER_CONFIG);
+	Config->EvtTimerFunc = EvtTimerFunc;
+	Config->AutomaticSerialization = TRUE;
+	Config->UseHighResolutionTimer = WdfUseDefault;
+}
+
+NTSTATUS
+WdfTimerCreate(
+	IN PWDF_TIMER_CONFIG Config,
+	IN PWDF_OBJECT_ATTRIBUTES Attributes,
+	OUT WDFTIMER* Timer
+);
+
+BOOLEAN
+WdfTimerStart(
+	IN WDFTIMER Timer,
+	IN LONGLONG DueTime
+);
+
+BOOLEAN
+WdfTimerStop(
+	IN WDFTIMER Timer,
+	IN BOOLEAN Wait
+);
+
+//
+// Queues
+//
+NTSTATUS
+WdfIoQueueRetrieveNextRequest(
+	IN WDFQUEUE Queue,
+	OUT WDFREQUEST* OutRequest
+);
@@ -0,0 +1,361 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		wdm.h
+
+	Abstract:
+
+		Host replacement for the kernel definitions used by the event
+		pipeline, so that it builds and runs as a user mode library
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#pragma once
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+
+//
+// Basic types, with the sizes they have on Windows
+//
+#define VOID void
+#define IN
+#define OUT
+#define OPTIONAL
+
+#define _In_
+#define _In_opt_
+#define _Out_
+#define _Out_opt_
+#define _Inout_
+#define _Inout_opt_
+#define _In_reads_bytes_(n)
+#define _Out_writes_bytes_(n)
+#define _IRQL_requires_max_(n)
+#define _Function_class_(n)
+
+typedef void* PVOID;
+typedef char CHAR;
+typedef unsigned char UCHAR, * PUCHAR;
+typedef unsigned char BYTE, * PBYTE;
+typedef unsigned char BOOLEAN, * PBOOLEAN;
+typedef short SHORT;
+typedef unsigned short USHORT, * PUSHORT;
+typedef unsigned short WORD;
+typedef int32_t LONG, * PLONG;
+typedef uint32_t ULONG, * PULONG;
+typedef uint32_t DWORD;
+typedef int32_t INT32;
+typedef uint32_t UINT32;
+typedef int64_t LONGLONG, * PLONGLONG;
+typedef int64_t LONG64;
+typedef uint64_t ULONGLONG;
+typedef uint64_t ULONG64, * PULONG64;
+typedef uintptr_t ULONG_PTR;
+typedef uintptr_t SIZE_T;
+typedef intptr_t LONG_PTR;
+typedef wchar_t WCHAR;
+typedef WCHAR* PWSTR;
+typedef const WCHAR* PCWSTR;
+typedef void* HANDLE;
+
+typedef LONG NTSTATUS;
+
+typedef union _LARGE_INTEGER
+{
+	struct
+	{
+		ULONG LowPart;
+		LONG HighPart;
+	};
+	LONGLONG QuadPart;
+} LARGE_INTEGER, * PLARGE_INTEGER;
+
+typedef struct _GUID
+{
+	ULONG Data1;
+	USHORT Data2;
+	USHORT Data3;
+	UCHAR Data4[8];
+} GUID;
+
+typedef const GUID* LPCGUID;
+
+#ifndef NULL
+#define NULL ((void*)0)
+#endif
+
+#define TRUE 1
+#define FALSE 0
+
+#define MAXULONG 0xFFFFFFFFUL
+
+#define ARRAYSIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+#define FIELD_OFFSET(type, field) ((LONG)offsetof(type, field))
+#define C_ASSERT(e) _Static_assert(e, #e)
+#define NT_ASSERT(e) assert(e)
+#define UNREFERENCED_PARAMETER(p) ((void)(p))
+
+//
+// Status codes
+//
+#define NT_SUCCESS(Status) (((NTSTATUS)(Status)) >= 0)
+
+#define STATUS_SUCCESS                  ((NTSTATUS)0x00000000L)
+#define STATUS_TIMEOUT                  ((NTSTATUS)0x00000102L)
+#define STATUS_PENDING                  ((NTSTATUS)0x00000103L)
+#define STATUS_NOTIFY_CLEANUP           ((NTSTATUS)0x0000010BL)
+#define STATUS_NO_MORE_ENTRIES          ((NTSTATUS)0x8000001AL)
+#define STATUS_NO_DATA_DETECTED         ((NTSTATUS)0x80000022L)
+#define STATUS_UNSUCCESSFUL             ((NTSTATUS)0xC0000001L)
+#define STATUS_NOT_IMPLEMENTED          ((NTSTATUS)0xC0000002L)
+#define STATUS_INVALID_PARAMETER        ((NTSTATUS)0xC000000DL)
+#define STATUS_BUFFER_TOO_SMALL         ((NTSTATUS)0xC0000023L)
+#define STATUS_OBJECT_NAME_NOT_FOUND    ((NTSTATUS)0xC0000034L)
+#define STATUS_INSUFFICIENT_RESOURCES   ((NTSTATUS)0xC000009AL)
+#define STATUS_DEVICE_NOT_READY         ((NTSTATUS)0xC00000A3L)
+#define STATUS_IO_DEVICE_ERROR          ((NTSTATUS)0xC0000185L)
+#define STATUS_IO_TIMEOUT               ((NTSTATUS)0xC00000B5L)
+
+//
+// Memory
+//
+#define RtlCopyMemory(d, s, n) memcpy((d), (s), (n))
+#define RtlMoveMemory(d, s, n) memmove((d), (s), (n))
+#define RtlZeroMemory(d, n) memset((d), 0, (n))
+#define RtlFillMemory(d, n, f) memset((d), (f), (n))
+
+typedef enum _POOL_TYPE
+{
+	NonPagedPool = 0,
+	PagedPool = 1,
+	NonPagedPoolNx = 512,
+} POOL_TYPE;
+
+PVOID
+ExAllocatePoolWithTag(
+	IN POOL_TYPE PoolType,
+	IN SIZE_T NumberOfBytes,
+	IN ULONG Tag
+);
+
+VOID
+ExFreePoolWithTag(
+	IN PVOID P,
+	IN ULONG Tag
+);
+
+//
+// IRQL and threads, every host thread starts at PASSIVE_LEVEL and is
+// raised to DISPATCH_LEVEL while it holds a spin lock
+//
+typedef UCHAR KIRQL;
+
+#define PASSIVE_LEVEL 0
+#define APC_LEVEL 1
+#define DISPATCH_LEVEL 2
+
+typedef struct _KTHREAD* PKTHREAD;
+
+typedef enum _KPROCESSOR_MODE
+{
+	KernelMode = 0,
+	UserMode = 1,
+} KPROCESSOR_MODE;
+
+typedef struct _KEVENT
+{
+	volatile LONG Signaled;
+} KEVENT, * PKEVENT;
+
+typedef enum _DEVICE_POWER_STATE
+{
+	PowerDeviceUnspecified = 0,
+	PowerDeviceD0,
+	PowerDeviceD1,
+	PowerDeviceD2,
+	PowerDeviceD3,
+	PowerDeviceMaximum
+} DEVICE_POWER_STATE, * PDEVICE_POWER_STATE;
+
+KIRQL
+KeGetCurrentIrql(
+	VOID
+);
+
+PKTHREAD
+KeGetCurrentThread(
+	VOID
+);
+
+ULONGLONG
+KeQueryInterruptTime(
+	VOID
+);
+
+ULONGLONG
+KeQueryInterruptTimePrecise(
+	OUT PULONG64 QpcTimeStamp
+);
+
+NTSTATUS
+KeDelayExecutionThread(
+	IN KPROCESSOR_MODE WaitMode,
+	IN BOOLEAN Alertable,
+	IN PLARGE_INTEGER Interval
+);
+
+//
+// Interlocked operations, all of them full barriers as on Windows
+//
+static inline LONG
+InterlockedIncrement(
+	volatile LONG* Addend
+)
+{
+	return __atomic_add_fetch(Addend, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG
+InterlockedDecrement(
+	volatile LONG* Addend
+)
+{
+	return __atomic_sub_fetch(Addend, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG
+InterlockedExchange(
+	volatile LONG* Target,
+	LONG Value
+)
+{
+	return __atomic_exchange_n(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG64
+InterlockedExchange64(
+	volatile LONG64* Target,
+	LONG64 Value
+)
+{
+	return __atomic_exchange_n(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG
+InterlockedCompareExchange(
+	volatile LONG* Destination,
+	LONG Exchange,
+	LONG Comperand
+)
+{
+	__atomic_compare_exchange_n(
+		Destination,
+		&Comperand,
+		Exchange,
+		FALSE,
+		__ATOMIC_SEQ_CST,
+		__ATOMIC_SEQ_CST);
+
+	return Comperand;
+}
+
+static inline LONG
+ReadAcquire(
+	const volatile LONG* Source
+)
+{
+	return __atomic_load_n(Source, __ATOMIC_ACQUIRE);
+}
+
+static inline LONG
+ReadNoFence(
+	const volatile LONG* Source
+)
+{
+	return __atomic_load_n(Source, __ATOMIC_RELAXED);
+}
+
+static inline LONG64
+ReadNoFence64(
+	const volatile LONG64* Source
+)
+{
+	return __atomic_load_n(Source, __ATOMIC_RELAXED);
+}
+
+static inline BOOLEAN
+_BitScanReverse(
+	ULONG* Index,
+	ULONG Mask
+)
+{
+	if (Mask == 0)
+	{
+		return FALSE;
+	}
+
+	*Index = 31 - (ULONG)__builtin_clz(Mask);
+
+	return TRUE;
+}
+
+//
+// Registry, RTL_QUERY_REGISTRY_DIRECT queries of REG_DWORD values are
+// answered from the values set with HostRegistrySetValue
+//
+#define REG_DWORD 4
+
+#define RTL_REGISTRY_ABSOLUTE 0
+
+#define RTL_QUERY_REGISTRY_DIRECT 0x00000020
+
+typedef NTSTATUS
+(*PRTL_QUERY_REGISTRY_ROUTINE)(
+	PWSTR ValueName,
+	ULONG ValueType,
+	PVOID ValueData,
+	ULONG ValueLength,
+	PVOID Context,
+	PVOID EntryContext
+);
+
+typedef struct _RTL_QUERY_REGISTRY_TABLE
+{
+	PRTL_QUERY_REGISTRY_ROUTINE QueryRoutine;
+	ULONG Flags;
+	PWSTR Name;
+	PVOID EntryContext;
+	ULONG DefaultType;
+	PVOID DefaultData;
+	ULONG DefaultLength;
+} RTL_QUERY_REGISTRY_TABLE, * PRTL_QUERY_REGISTRY_TABLE;
+
+NTSTATUS
+RtlQueryRegistryValues(
+	IN ULONG RelativeTo,
+	IN PCWSTR Path,
+	IN PRTL_QUERY_REGISTRY_TABLE QueryTable,
+	IN PVOID Context,
+	IN PVOID Environment
+);
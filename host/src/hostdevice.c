@@ -0,0 +1,175 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		hostdevice.c
+
+	Abstract:
+
+		Host device wiring the event pipeline to the simulated controller,
+		following the steps OnPrepareHardware, OnInterruptIsr and
+		TchReadReport take on the driver side
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#include <hostshim.h>
+
+VOID
+TchGetTouchSettings(
+	IN PTOUCH_SCREEN_SETTINGS TouchSettings
+)
+{
+	//
+	// Only the self-test and power paths read these settings
+	//
+	RtlZeroMemory(TouchSettings, sizeof(TOUCH_SCREEN_SETTINGS));
+}
+
+VOID
+TchTraceReport(
+	IN PHID_INPUT_REPORT hidReportFromDriver,
+	IN ULONG ContactsPerReport
+)
+{
+	UNREFERENCED_PARAMETER(hidReportFromDriver);
+	UNREFERENCED_PARAMETER(ContactsPerReport);
+}
+
+NTSTATUS
+TchCompleteReadRequest(
+	IN WDFREQUEST request,
+	IN PHID_INPUT_REPORT hidReportFromDriver,
+	IN ULONG ContactsPerReport
+)
+{
+	HostQueueCompleteRead(request, hidReportFromDriver, ContactsPerReport);
+
+	return STATUS_SUCCESS;
+}
+
+NTSTATUS
+HostDeviceCreate(
+	OUT HOST_DEVICE* Device,
+	IN FTS_CHIP_FAMILY ChipFamily
+)
+{
+	NTSTATUS status;
+	PVOID touchContext = NULL;
+
+	RtlZeroMemory(Device, sizeof(HOST_DEVICE));
+
+	status = HostDeviceObjectCreate(&Device->FxDevice);
+
+	if (!NT_SUCCESS(status))
+	{
+		goto exit;
+	}
+
+	HostFtsChipInitialize(&Device->Chip, ChipFamily);
+	Device->I2CContext.SpbIoTarget = (WDFIOTARGET)&Device->Chip;
+
+	status = HostQueueCreate(Device->FxDevice, &Device->ReportContext.PingPongQueue);
+
+	if (!NT_SUCCESS(status))
+	{
+		goto exit;
+	}
+
+	TchGetScreenProperties(&Device->ReportContext.Props);
+
+	TchBuildTranslation(
+		&Device->ReportContext.Translation,
+		&Device->ReportContext.Props);
+
+	status = ReportConfigureContinuousSimulationTimer(
+		Device->FxDevice,
+		&Device->ReportContext);
+
+	if (!NT_SUCCESS(status))
+	{
+		goto exit;
+	}
+
+	status = TchAllocateContext(&touchContext, Device->FxDevice);
+
+	if (!NT_SUCCESS(status))
+	{
+		goto exit;
+	}
+
+	Device->TouchContext = touchContext;
+
+	status = TchStartDevice(Device->TouchContext, &Device->I2CContext);
+
+	if (!NT_SUCCESS(status))
+	{
+		goto exit;
+	}
+
+exit:
+	if (!NT_SUCCESS(status))
+	{
+		HostDeviceDestroy(Device);
+	}
+
+	return status;
+}
+
+VOID
+HostDeviceDestroy(
+	IN HOST_DEVICE* Device
+)
+{
+	if (Device->TouchContext != NULL)
+	{
+		TchFreeContext(Device->TouchContext);
+		Device->TouchContext = NULL;
+	}
+
+	if (Device->FxDevice != NULL)
+	{
+		WdfObjectDelete(Device->FxDevice);
+		Device->FxDevice = NULL;
+	}
+}
+
+NTSTATUS
+HostDeviceInterrupt(
+	IN HOST_DEVICE* Device
+)
+{
+	NTSTATUS status;
+
+	TraceHotRing(TRACE_HOT_ISR_ENTRY, 0);
+
+	LatencyStartFrame(&Device->ReportContext.Latency);
+
+	status = FtsServiceInterrupts(
+		Device->TouchContext,
+		&Device->I2CContext,
+		&Device->ReportContext);
+
+	LatencyEndFrame(&Device->ReportContext.Latency);
+
+	TraceHotRing(TRACE_HOT_ISR_EXIT, status);
+
+	return status;
+}
+
+VOID
+HostDeviceRead(
+	IN HOST_DEVICE* Device,
+	IN ULONG Count
+)
+{
+	HostQueuePostReads(Device->ReportContext.PingPongQueue, Count);
+
+	ReportDrainRing(&Device->ReportContext);
+}
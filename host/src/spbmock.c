@@ -0,0 +1,280 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		spbmock.c
+
+	Abstract:
+
+		Simulated FTS controller answering the SPB helper routines, the
+		SPB I/O target of a host device is the simulated chip
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#include <hostshim.h>
+
+#define HOST_FTS_CHIP_FROM_SPB(SpbContext) ((HOST_FTS_CHIP*)(SpbContext)->SpbIoTarget)
+
+VOID
+HostFtsChipInitialize(
+	OUT HOST_FTS_CHIP* Chip,
+	IN FTS_CHIP_FAMILY ChipFamily
+)
+{
+	RtlZeroMemory(Chip, sizeof(HOST_FTS_CHIP));
+	Chip->ChipFamily = ChipFamily;
+}
+
+BOOLEAN
+HostFtsChipPushEvent(
+	IN HOST_FTS_CHIP* Chip,
+	IN const BYTE* Event
+)
+{
+	if (Chip->FifoCount == FIFO_DEPTH)
+	{
+		Chip->LostEvents++;
+		return FALSE;
+	}
+
+	RtlCopyMemory(
+		Chip->Fifo[(Chip->FifoHead + Chip->FifoCount) % FIFO_DEPTH],
+		Event,
+		FIFO_EVENT_SIZE);
+
+	Chip->FifoCount++;
+
+	return TRUE;
+}
+
+VOID
+HostFtsBuildPointerEvent(
+	OUT BYTE* Event,
+	IN BYTE EventId,
+	IN BYTE TouchId,
+	IN USHORT X,
+	IN USHORT Y,
+	IN UCHAR Pressure,
+	IN UCHAR Size
+)
+{
+	Event[0] = EventId;
+	Event[1] = 0;
+	Event[2] = TouchId & 0x0F;
+	Event[3] = (BYTE)(X >> 4);
+	Event[4] = (BYTE)(Y >> 4);
+	Event[5] = (BYTE)(((X & 0x0F) << 4) | (Y & 0x0F));
+	Event[6] = Pressure & 0x3F;
+	Event[7] = (BYTE)((Size & 0x07) << 5);
+}
+
+static NTSTATUS
+HostFtsChipReadFifo(
+	IN HOST_FTS_CHIP* Chip,
+	OUT BYTE* Data,
+	IN ULONG Length
+)
+{
+	ULONG events = Length / FIFO_EVENT_SIZE;
+	ULONG i;
+	BOOLEAN fail;
+	BYTE* event;
+
+	fail = Chip->FailRead != 0 && Chip->Reads == Chip->FailRead;
+
+	RtlZeroMemory(Data, Length);
+
+	for (i = 0; i < events && Chip->FifoCount != 0; i++)
+	{
+		event = Data + i * FIFO_EVENT_SIZE;
+
+		RtlCopyMemory(event, Chip->Fifo[Chip->FifoHead], FIFO_EVENT_SIZE);
+
+		Chip->FifoHead = (Chip->FifoHead + 1) % FIFO_DEPTH;
+		Chip->FifoCount--;
+
+		event[7] = (BYTE)((event[7] & ~EVENT_LEFT_EVENTS_SATURATED) |
+			min(Chip->FifoCount, EVENT_LEFT_EVENTS_SATURATED));
+	}
+
+	//
+	// A failed read still popped the events it covered
+	//
+	if (fail)
+	{
+		RtlZeroMemory(Data, Length);
+		return STATUS_IO_DEVICE_ERROR;
+	}
+
+	return STATUS_SUCCESS;
+}
+
+static NTSTATUS
+HostFtsChipRead(
+	IN HOST_FTS_CHIP* Chip,
+	IN UCHAR Address,
+	OUT PVOID Data,
+	IN ULONG Length
+)
+{
+	Chip->Reads++;
+	Chip->BytesWritten += sizeof(Address);
+	Chip->BytesRead += Length;
+
+	if (Address == FIFO_CMD_READONE || Address == FIFO_CMD_READALL)
+	{
+		return HostFtsChipReadFifo(Chip, Data, Length);
+	}
+
+	RtlZeroMemory(Data, Length);
+
+	return STATUS_SUCCESS;
+}
+
+NTSTATUS
+SpbReadDataSynchronously(
+	_In_ SPB_CONTEXT* SpbContext,
+	_In_ UCHAR Address,
+	_In_reads_bytes_(Length) PVOID Data,
+	_In_ ULONG Length
+)
+{
+	HOST_FTS_CHIP* chip = HOST_FTS_CHIP_FROM_SPB(SpbContext);
+
+	NT_ASSERT(!chip->AsyncPending);
+
+	return HostFtsChipRead(chip, Address, Data, Length);
+}
+
+NTSTATUS
+SpbReadDataAsynchronously(
+	_In_ SPB_CONTEXT* SpbContext,
+	_In_ UCHAR Address,
+	_In_reads_bytes_(Length) PVOID Data,
+	_In_ ULONG Length,
+	_In_opt_ PFN_SPB_ASYNC_COMPLETION Completion,
+	_In_opt_ PVOID CompletionContext
+)
+{
+	HOST_FTS_CHIP* chip = HOST_FTS_CHIP_FROM_SPB(SpbContext);
+
+	NT_ASSERT(!chip->AsyncPending);
+
+	//
+	// The simulated bus completes the read right away
+	//
+	chip->AsyncStatus = HostFtsChipRead(chip, Address, Data, Length);
+	chip->AsyncPending = TRUE;
+
+	if (Completion != NULL)
+	{
+		Completion(SpbContext, chip->AsyncStatus, CompletionContext);
+	}
+
+	return STATUS_SUCCESS;
+}
+
+NTSTATUS
+SpbWaitForAsynchronousRead(
+	_In_ SPB_CONTEXT* SpbContext
+)
+{
+	HOST_FTS_CHIP* chip = HOST_FTS_CHIP_FROM_SPB(SpbContext);
+
+	NT_ASSERT(chip->AsyncPending);
+
+	chip->AsyncPending = FALSE;
+
+	return chip->AsyncStatus;
+}
+
+NTSTATUS
+SpbReadRegisterSynchronously(
+	_In_ SPB_CONTEXT* SpbContext,
+	_In_ UCHAR Command,
+	_In_ PVOID Register,
+	_In_ ULONG RegisterLength,
+	_In_reads_bytes_(Length) PVOID Data,
+	_In_ ULONG Length
+)
+{
+	HOST_FTS_CHIP* chip = HOST_FTS_CHIP_FROM_SPB(SpbContext);
+	static const BYTE chipIdFTM3[] = { CHIP_ID_ADDR_FTM3 };
+	static const BYTE chipIdFTM4[] = { CHIP_ID_ADDR_FTM4 };
+	BYTE* data = Data;
+
+	NT_ASSERT(!chip->AsyncPending);
+
+	chip->Reads++;
+	chip->BytesWritten += sizeof(Command) + RegisterLength;
+	chip->BytesRead += Length;
+
+	RtlZeroMemory(Data, Length);
+
+	if (Command != FTS_CMD_HW_REG_R || RegisterLength != 2 || Length < CHIP_ID_READ_SIZE)
+	{
+		return STATUS_SUCCESS;
+	}
+
+	//
+	// The first byte read is a dummy byte
+	//
+	if (chip->ChipFamily == FTS_CHIP_FAMILY_FTM3 &&
+		memcmp(Register, chipIdFTM3, sizeof(chipIdFTM3)) == 0)
+	{
+		data[1] = CHIP_ID_FTM3_0;
+		data[2] = CHIP_ID_FTM3_1;
+	}
+	else if (chip->ChipFamily == FTS_CHIP_FAMILY_FTM4 &&
+		memcmp(Register, chipIdFTM4, sizeof(chipIdFTM4)) == 0)
+	{
+		data[1] = CHIP_ID_FTM4_0;
+		data[2] = CHIP_ID_FTM4_1;
+	}
+
+	return STATUS_SUCCESS;
+}
+
+NTSTATUS
+SpbWriteDataSynchronously(
+	IN SPB_CONTEXT* SpbContext,
+	IN UCHAR Address,
+	IN PVOID Data,
+	IN ULONG Length
+)
+{
+	HOST_FTS_CHIP* chip = HOST_FTS_CHIP_FROM_SPB(SpbContext);
+	static const BYTE enableFTM3[] = { IER_ADDR_FTM3, IER_ENABLE };
+	static const BYTE enableFTM4[] = { IER_ADDR_FTM4, IER_ENABLE };
+
+	NT_ASSERT(!chip->AsyncPending);
+
+	chip->Writes++;
+	chip->BytesWritten += sizeof(Address) + Length;
+
+	if (Address == FIFO_CMD_FLUSH)
+	{
+		chip->FifoCount = 0;
+		chip->Flushes++;
+	}
+	else if (Address == FTS_CMD_HW_REG_W && Length == sizeof(enableFTM3))
+	{
+		//
+		// Only the register of the actual chip enables its interrupts
+		//
+		if ((chip->ChipFamily != FTS_CHIP_FAMILY_FTM4 && memcmp(Data, enableFTM3, Length) == 0) ||
+			(chip->ChipFamily != FTS_CHIP_FAMILY_FTM3 && memcmp(Data, enableFTM4, Length) == 0))
+		{
+			chip->InterruptEnableWrites++;
+		}
+	}
+
+	return STATUS_SUCCESS;
+}
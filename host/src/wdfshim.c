@@ -0,0 +1,851 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		wdfshim.c
+
+	Abstract:
+
+		Host implementation of the kernel and framework routines used by
+		the event pipeline
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <hostshim.h>
+
+//
+// Hot path event ring, see TraceHotRing
+//
+TRACE_HOT_EVENT gTraceHotRing[TRACE_HOT_RING_SIZE];
+volatile LONG gTraceHotRingIndex = -1;
+
+typedef enum _HOST_WDF_OBJECT_TYPE
+{
+	HostObjectDevice,
+	HostObjectSpinLock,
+	HostObjectWaitLock,
+	HostObjectTimer,
+	HostObjectQueue,
+	HostObjectRequest,
+} HOST_WDF_OBJECT_TYPE;
+
+struct _HOST_WDF_OBJECT
+{
+	HOST_WDF_OBJECT_TYPE Type;
+	struct _HOST_WDF_OBJECT* Parent;
+	struct _HOST_WDF_OBJECT* Children;
+	struct _HOST_WDF_OBJECT* NextSibling;
+	PVOID Context;
+
+	//
+	// Spin locks and wait locks, and the state of queues
+	//
+	pthread_mutex_t Mutex;
+	KIRQL SavedIrql;
+
+	//
+	// Timers
+	//
+	PFN_WDF_TIMER TimerFunc;
+	BOOLEAN TimerQueued;
+	ULONG64 TimerDueTime;
+
+	//
+	// Queues, a queue has a single request object completed over and
+	// over again for every pending read
+	//
+	ULONG PendingReads;
+	HOST_REPORT* Reports;
+	ULONG ReportCount;
+	ULONG ReportCapacity;
+	struct _HOST_WDF_OBJECT* Request;
+};
+
+//
+// Serializes the object tree and the timer state
+//
+static pthread_mutex_t gHostObjectLock = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread KIRQL tHostIrql = PASSIVE_LEVEL;
+static __thread char tHostThread;
+
+static volatile LONG gHostPoolAllocations;
+static volatile LONG gHostPoolOutstanding;
+
+static volatile BOOLEAN gHostClockFrozen;
+static volatile ULONG64 gHostClock;
+
+//
+// Clock
+//
+
+static ULONG64
+HostMonotonicTime(
+	VOID
+)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (ULONG64)now.tv_sec * 10000000ULL + (ULONG64)now.tv_nsec / 100;
+}
+
+VOID
+HostClockSet(
+	IN ULONG64 Time
+)
+{
+	__atomic_store_n(&gHostClock, Time, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&gHostClockFrozen, TRUE, __ATOMIC_SEQ_CST);
+}
+
+VOID
+HostClockAdvance(
+	IN ULONG64 Delta
+)
+{
+	__atomic_add_fetch(&gHostClock, Delta, __ATOMIC_SEQ_CST);
+}
+
+ULONGLONG
+KeQueryInterruptTime(
+	VOID
+)
+{
+	if (__atomic_load_n(&gHostClockFrozen, __ATOMIC_SEQ_CST))
+	{
+		return __atomic_load_n(&gHostClock, __ATOMIC_SEQ_CST);
+	}
+
+	return HostMonotonicTime();
+}
+
+ULONGLONG
+KeQueryInterruptTimePrecise(
+	OUT PULONG64 QpcTimeStamp
+)
+{
+	ULONGLONG time = KeQueryInterruptTime();
+
+	*QpcTimeStamp = time;
+
+	return time;
+}
+
+NTSTATUS
+KeDelayExecutionThread(
+	IN KPROCESSOR_MODE WaitMode,
+	IN BOOLEAN Alertable,
+	IN PLARGE_INTEGER Interval
+)
+{
+	ULONG64 delay;
+	struct timespec sleep;
+
+	UNREFERENCED_PARAMETER(WaitMode);
+	UNREFERENCED_PARAMETER(Alertable);
+
+	NT_ASSERT(tHostIrql == PASSIVE_LEVEL);
+
+	//
+	// Only relative intervals are used by the driver
+	//
+	NT_ASSERT(Interval->QuadPart <= 0);
+
+	delay = (ULONG64)-Interval->QuadPart;
+
+	if (__atomic_load_n(&gHostClockFrozen, __ATOMIC_SEQ_CST))
+	{
+		HostClockAdvance(delay);
+		return STATUS_SUCCESS;
+	}
+
+	sleep.tv_sec = (time_t)(delay / 10000000ULL);
+	sleep.tv_nsec = (long)(delay % 10000000ULL) * 100;
+
+	while (nanosleep(&sleep, &sleep) != 0 && errno == EINTR)
+	{
+	}
+
+	return STATUS_SUCCESS;
+}
+
+//
+// IRQL and threads
+//
+
+KIRQL
+KeGetCurrentIrql(
+	VOID
+)
+{
+	return tHostIrql;
+}
+
+PKTHREAD
+KeGetCurrentThread(
+	VOID
+)
+{
+	return (PKTHREAD)&tHostThread;
+}
+
+//
+// Pool
+//
+
+PVOID
+ExAllocatePoolWithTag(
+	IN POOL_TYPE PoolType,
+	IN SIZE_T NumberOfBytes,
+	IN ULONG Tag
+)
+{
+	PVOID p;
+
+	UNREFERENCED_PARAMETER(PoolType);
+	UNREFERENCED_PARAMETER(Tag);
+
+	p = malloc(NumberOfBytes);
+
+	if (p != NULL)
+	{
+		InterlockedIncrement(&gHostPoolAllocations);
+		InterlockedIncrement(&gHostPoolOutstanding);
+	}
+
+	return p;
+}
+
+VOID
+ExFreePoolWithTag(
+	IN PVOID P,
+	IN ULONG Tag
+)
+{
+	UNREFERENCED_PARAMETER(Tag);
+
+	NT_ASSERT(P != NULL);
+
+	InterlockedDecrement(&gHostPoolOutstanding);
+	free(P);
+}
+
+LONG
+HostPoolAllocations(
+	VOID
+)
+{
+	return ReadAcquire(&gHostPoolAllocations);
+}
+
+LONG
+HostPoolOutstanding(
+	VOID
+)
+{
+	return ReadAcquire(&gHostPoolOutstanding);
+}
+
+//
+// Registry
+//
+
+#define HOST_REGISTRY_VALUES 64
+#define HOST_REGISTRY_NAME_LENGTH 128
+
+typedef struct _HOST_REGISTRY_VALUE
+{
+	WCHAR Path[HOST_REGISTRY_NAME_LENGTH];
+	WCHAR Name[HOST_REGISTRY_NAME_LENGTH];
+	ULONG Value;
+} HOST_REGISTRY_VALUE;
+
+static HOST_REGISTRY_VALUE gHostRegistry[HOST_REGISTRY_VALUES];
+static ULONG gHostRegistryCount;
+
+static HOST_REGISTRY_VALUE*
+HostRegistryFind(
+	IN PCWSTR Path,
+	IN PCWSTR Name
+)
+{
+	ULONG i;
+
+	for (i = 0; i < gHostRegistryCount; i++)
+	{
+		if (wcscmp(gHostRegistry[i].Path, Path) == 0 &&
+			(Name == NULL || wcscmp(gHostRegistry[i].Name, Name) == 0))
+		{
+			return &gHostRegistry[i];
+		}
+	}
+
+	return NULL;
+}
+
+VOID
+HostRegistrySetValue(
+	IN PCWSTR Path,
+	IN PCWSTR Name,
+	IN ULONG Value
+)
+{
+	HOST_REGISTRY_VALUE* value = HostRegistryFind(Path, Name);
+
+	if (value == NULL)
+	{
+		NT_ASSERT(gHostRegistryCount < HOST_REGISTRY_VALUES);
+		NT_ASSERT(wcslen(Path) < HOST_REGISTRY_NAME_LENGTH);
+		NT_ASSERT(wcslen(Name) < HOST_REGISTRY_NAME_LENGTH);
+
+		value = &gHostRegistry[gHostRegistryCount++];
+		wcscpy(value->Path, Path);
+		wcscpy(value->Name, Name);
+	}
+
+	value->Value = Value;
+}
+
+VOID
+HostRegistryClear(
+	VOID
+)
+{
+	gHostRegistryCount = 0;
+}
+
+NTSTATUS
+RtlQueryRegistryValues(
+	IN ULONG RelativeTo,
+	IN PCWSTR Path,
+	IN PRTL_QUERY_REGISTRY_TABLE QueryTable,
+	IN PVOID Context,
+	IN PVOID Environment
+)
+{
+	PRTL_QUERY_REGISTRY_TABLE entry;
+	HOST_REGISTRY_VALUE* value;
+
+	UNREFERENCED_PARAMETER(Context);
+	UNREFERENCED_PARAMETER(Environment);
+
+	NT_ASSERT(RelativeTo == RTL_REGISTRY_ABSOLUTE);
+
+	//
+	// A key without any value does not exist
+	//
+	if (HostRegistryFind(Path, NULL) == NULL)
+	{
+		return STATUS_OBJECT_NAME_NOT_FOUND;
+	}
+
+	for (entry = QueryTable; entry->QueryRoutine != NULL || entry->Name != NULL; entry++)
+	{
+		NT_ASSERT(entry->Flags & RTL_QUERY_REGISTRY_DIRECT);
+
+		value = HostRegistryFind(Path, entry->Name);
+
+		if (value != NULL)
+		{
+			*(ULONG*)entry->EntryContext = value->Value;
+		}
+		else if (entry->DefaultType == REG_DWORD && entry->DefaultData != NULL)
+		{
+			RtlCopyMemory(entry->EntryContext, entry->DefaultData, entry->DefaultLength);
+		}
+	}
+
+	return STATUS_SUCCESS;
+}
+
+//
+// Objects
+//
+
+static NTSTATUS
+HostObjectCreate(
+	IN HOST_WDF_OBJECT_TYPE Type,
+	IN PWDF_OBJECT_ATTRIBUTES Attributes,
+	OUT WDFOBJECT* Object
+)
+{
+	WDFOBJECT object;
+	pthread_mutexattr_t mutexAttributes;
+
+	object = calloc(1, sizeof(*object));
+
+	if (object == NULL)
+	{
+		return STATUS_INSUFFICIENT_RESOURCES;
+	}
+
+	object->Type = Type;
+
+	if (Attributes != WDF_NO_OBJECT_ATTRIBUTES && Attributes->ContextTypeInfo != NULL)
+	{
+		object->Context = calloc(1, Attributes->ContextTypeInfo->ContextSize);
+
+		if (object->Context == NULL)
+		{
+			free(object);
+			return STATUS_INSUFFICIENT_RESOURCES;
+		}
+	}
+
+	//
+	// Recursive acquisition is a bug, make it fail rather than hang
+	//
+	pthread_mutexattr_init(&mutexAttributes);
+	pthread_mutexattr_settype(&mutexAttributes, PTHREAD_MUTEX_ERRORCHECK);
+	pthread_mutex_init(&object->Mutex, &mutexAttributes);
+	pthread_mutexattr_destroy(&mutexAttributes);
+
+	if (Attributes != WDF_NO_OBJECT_ATTRIBUTES && Attributes->ParentObject != NULL)
+	{
+		pthread_mutex_lock(&gHostObjectLock);
+
+		object->Parent = Attributes->ParentObject;
+		object->NextSibling = object->Parent->Children;
+		object->Parent->Children = object;
+
+		pthread_mutex_unlock(&gHostObjectLock);
+	}
+
+	*Object = object;
+
+	return STATUS_SUCCESS;
+}
+
+static VOID
+HostObjectFree(
+	IN WDFOBJECT Object
+)
+{
+	WDFOBJECT child;
+
+	while ((child = Object->Children) != NULL)
+	{
+		Object->Children = child->NextSibling;
+		HostObjectFree(child);
+	}
+
+	pthread_mutex_destroy(&Object->Mutex);
+	free(Object->Reports);
+	free(Object->Context);
+	free(Object);
+}
+
+VOID
+WdfObjectDelete(
+	IN WDFOBJECT Object
+)
+{
+	WDFOBJECT* link;
+
+	pthread_mutex_lock(&gHostObjectLock);
+
+	if (Object->Parent != NULL)
+	{
+		for (link = &Object->Parent->Children; *link != Object; link = &(*link)->NextSibling)
+		{
+			NT_ASSERT(*link != NULL);
+		}
+
+		*link = Object->NextSibling;
+	}
+
+	HostObjectFree(Object);
+
+	pthread_mutex_unlock(&gHostObjectLock);
+}
+
+PVOID
+HostWdfObjectGetContext(
+	IN WDFOBJECT Object
+)
+{
+	NT_ASSERT(Object->Context != NULL);
+
+	return Object->Context;
+}
+
+NTSTATUS
+HostDeviceObjectCreate(
+	OUT WDFDEVICE* Device
+)
+{
+	return HostObjectCreate(HostObjectDevice, WDF_NO_OBJECT_ATTRIBUTES, Device);
+}
+
+//
+// Locks
+//
+
+NTSTATUS
+WdfSpinLockCreate(
+	IN PWDF_OBJECT_ATTRIBUTES SpinLockAttributes,
+	OUT WDFSPINLOCK* SpinLock
+)
+{
+	return HostObjectCreate(HostObjectSpinLock, SpinLockAttributes, SpinLock);
+}
+
+VOID
+WdfSpinLockAcquire(
+	IN WDFSPINLOCK SpinLock
+)
+{
+	int error;
+
+	NT_ASSERT(SpinLock->Type == HostObjectSpinLock);
+	NT_ASSERT(tHostIrql <= DISPATCH_LEVEL);
+
+	error = pthread_mutex_lock(&SpinLock->Mutex);
+	NT_ASSERT(error == 0);
+	(void)error;
+
+	SpinLock->SavedIrql = tHostIrql;
+	tHostIrql = DISPATCH_LEVEL;
+}
+
+VOID
+WdfSpinLockRelease(
+	IN WDFSPINLOCK SpinLock
+)
+{
+	NT_ASSERT(SpinLock->Type == HostObjectSpinLock);
+
+	tHostIrql = SpinLock->SavedIrql;
+
+	pthread_mutex_unlock(&SpinLock->Mutex);
+}
+
+NTSTATUS
+WdfWaitLockCreate(
+	IN PWDF_OBJECT_ATTRIBUTES LockAttributes,
+	OUT WDFWAITLOCK* Lock
+)
+{
+	return HostObjectCreate(HostObjectWaitLock, LockAttributes, Lock);
+}
+
+NTSTATUS
+WdfWaitLockAcquire(
+	IN WDFWAITLOCK Lock,
+	IN PLONGLONG Timeout
+)
+{
+	int error;
+
+	NT_ASSERT(Lock->Type == HostObjectWaitLock);
+	NT_ASSERT(Timeout == NULL);
+	NT_ASSERT(tHostIrql == PASSIVE_LEVEL);
+
+	UNREFERENCED_PARAMETER(Timeout);
+
+	error = pthread_mutex_lock(&Lock->Mutex);
+	NT_ASSERT(error == 0);
+	(void)error;
+
+	return STATUS_SUCCESS;
+}
+
+VOID
+WdfWaitLockRelease(
+	IN WDFWAITLOCK Lock
+)
+{
+	NT_ASSERT(Lock->Type == HostObjectWaitLock);
+
+	pthread_mutex_unlock(&Lock->Mutex);
+}
+
+//
+// Timers
+//
+
+NTSTATUS
+WdfTimerCreate(
+	IN PWDF_TIMER_CONFIG Config,
+	IN PWDF_OBJECT_ATTRIBUTES Attributes,
+	OUT WDFTIMER* Timer
+)
+{
+	NTSTATUS status;
+
+	NT_ASSERT(Config->Period == 0);
+
+	status = HostObjectCreate(HostObjectTimer, Attributes, Timer);
+
+	if (NT_SUCCESS(status))
+	{
+		(*Timer)->TimerFunc = Config->EvtTimerFunc;
+	}
+
+	return status;
+}
+
+BOOLEAN
+WdfTimerStart(
+	IN WDFTIMER Timer,
+	IN LONGLONG DueTime
+)
+{
+	BOOLEAN wasQueued;
+
+	NT_ASSERT(Timer->Type == HostObjectTimer);
+
+	pthread_mutex_lock(&gHostObjectLock);
+
+	wasQueued = Timer->TimerQueued;
+	Timer->TimerQueued = TRUE;
+	Timer->TimerDueTime = DueTime < 0 ?
+		KeQueryInterruptTime() + (ULONG64)-DueTime :
+		(ULONG64)DueTime;
+
+	pthread_mutex_unlock(&gHostObjectLock);
+
+	return wasQueued;
+}
+
+BOOLEAN
+WdfTimerStop(
+	IN WDFTIMER Timer,
+	IN BOOLEAN Wait
+)
+{
+	BOOLEAN wasQueued;
+
+	NT_ASSERT(Timer->Type == HostObjectTimer);
+	UNREFERENCED_PARAMETER(Wait);
+
+	pthread_mutex_lock(&gHostObjectLock);
+
+	wasQueued = Timer->TimerQueued;
+	Timer->TimerQueued = FALSE;
+
+	pthread_mutex_unlock(&gHostObjectLock);
+
+	return wasQueued;
+}
+
+BOOLEAN
+HostTimerQueued(
+	IN WDFTIMER Timer,
+	OUT ULONG64* DueTime
+)
+{
+	BOOLEAN queued;
+
+	pthread_mutex_lock(&gHostObjectLock);
+
+	queued = Timer->TimerQueued;
+
+	if (DueTime != NULL)
+	{
+		*DueTime = Timer->TimerDueTime;
+	}
+
+	pthread_mutex_unlock(&gHostObjectLock);
+
+	return queued;
+}
+
+BOOLEAN
+HostTimerFire(
+	IN WDFTIMER Timer
+)
+{
+	BOOLEAN queued;
+
+	pthread_mutex_lock(&gHostObjectLock);
+
+	queued = Timer->TimerQueued;
+	Timer->TimerQueued = FALSE;
+
+	pthread_mutex_unlock(&gHostObjectLock);
+
+	//
+	// Timer callbacks run at DISPATCH_LEVEL
+	//
+	if (queued)
+	{
+		tHostIrql = DISPATCH_LEVEL;
+		Timer->TimerFunc(Timer);
+		tHostIrql = PASSIVE_LEVEL;
+	}
+
+	return queued;
+}
+
+//
+// Queues
+//
+
+NTSTATUS
+HostQueueCreate(
+	IN WDFDEVICE Device,
+	OUT WDFQUEUE* Queue
+)
+{
+	WDF_OBJECT_ATTRIBUTES attributes;
+	NTSTATUS status;
+
+	WDF_OBJECT_ATTRIBUTES_INIT(&attributes);
+	attributes.ParentObject = Device;
+
+	status = HostObjectCreate(HostObjectQueue, &attributes, Queue);
+
+	if (!NT_SUCCESS(status))
+	{
+		goto exit;
+	}
+
+	attributes.ParentObject = *Queue;
+
+	status = HostObjectCreate(HostObjectRequest, &attributes, &(*Queue)->Request);
+
+	if (!NT_SUCCESS(status))
+	{
+		WdfObjectDelete(*Queue);
+		goto exit;
+	}
+
+exit:
+	return status;
+}
+
+VOID
+HostQueuePostReads(
+	IN WDFQUEUE Queue,
+	IN ULONG Count
+)
+{
+	pthread_mutex_lock(&Queue->Mutex);
+	Queue->PendingReads += Count;
+	pthread_mutex_unlock(&Queue->Mutex);
+}
+
+ULONG
+HostQueuePendingReads(
+	IN WDFQUEUE Queue
+)
+{
+	ULONG pending;
+
+	pthread_mutex_lock(&Queue->Mutex);
+	pending = Queue->PendingReads;
+	pthread_mutex_unlock(&Queue->Mutex);
+
+	return pending;
+}
+
+NTSTATUS
+WdfIoQueueRetrieveNextRequest(
+	IN WDFQUEUE Queue,
+	OUT WDFREQUEST* OutRequest
+)
+{
+	NTSTATUS status = STATUS_NO_MORE_ENTRIES;
+
+	NT_ASSERT(Queue->Type == HostObjectQueue);
+
+	pthread_mutex_lock(&Queue->Mutex);
+
+	if (Queue->PendingReads != 0)
+	{
+		Queue->PendingReads--;
+		*OutRequest = Queue->Request;
+		status = STATUS_SUCCESS;
+	}
+
+	pthread_mutex_unlock(&Queue->Mutex);
+
+	return status;
+}
+
+VOID
+HostQueueCompleteRead(
+	IN WDFREQUEST Request,
+	IN PHID_INPUT_REPORT Report,
+	IN ULONG ContactsPerReport
+)
+{
+	WDFQUEUE queue = Request->Parent;
+	HOST_REPORT* reports;
+	ULONG capacity;
+
+	NT_ASSERT(Request->Type == HostObjectRequest);
+
+	pthread_mutex_lock(&queue->Mutex);
+
+	if (queue->ReportCount == queue->ReportCapacity)
+	{
+		capacity = queue->ReportCapacity == 0 ? 64 : queue->ReportCapacity * 2;
+		reports = realloc(queue->Reports, capacity * sizeof(HOST_REPORT));
+		NT_ASSERT(reports != NULL);
+
+		queue->Reports = reports;
+		queue->ReportCapacity = capacity;
+	}
+
+	RtlCopyMemory(&queue->Reports[queue->ReportCount].Report, Report, sizeof(HID_INPUT_REPORT));
+	queue->Reports[queue->ReportCount].ContactsPerReport = ContactsPerReport;
+	queue->Reports[queue->ReportCount].Timestamp = KeQueryInterruptTime();
+	queue->ReportCount++;
+
+	pthread_mutex_unlock(&queue->Mutex);
+}
+
+ULONG
+HostQueueReportCount(
+	IN WDFQUEUE Queue
+)
+{
+	ULONG count;
+
+	pthread_mutex_lock(&Queue->Mutex);
+	count = Queue->ReportCount;
+	pthread_mutex_unlock(&Queue->Mutex);
+
+	return count;
+}
+
+const HOST_REPORT*
+HostQueueReport(
+	IN WDFQUEUE Queue,
+	IN ULONG Index
+)
+{
+	const HOST_REPORT* report;
+
+	pthread_mutex_lock(&Queue->Mutex);
+	report = Index < Queue->ReportCount ? &Queue->Reports[Index] : NULL;
+	pthread_mutex_unlock(&Queue->Mutex);
+
+	return report;
+}
+
+VOID
+HostQueueClearReports(
+	IN WDFQUEUE Queue
+)
+{
+	pthread_mutex_lock(&Queue->Mutex);
+	Queue->ReportCount = 0;
+	pthread_mutex_unlock(&Queue->Mutex);
+}
@@ -0,0 +1,348 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		descriptor.c
+
+	Abstract:
+
+		Walks the report descriptor of every finger contacts per report
+		variant and checks that the input reports it declares are laid out
+		as HID_INPUT_REPORT and HID_TOUCH_REPORT_CONTACT_COUNT fill them
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#include <stdio.h>
+#include <hostshim.h>
+
+#define DESCRIPTOR_MAX_FIELDS      128
+
+static int gFailures;
+
+#define DESCRIPTOR_CHECK(Contacts, Condition)                               \
+    do {                                                                    \
+        if (!(Condition)) {                                                 \
+            fprintf(stderr, "descriptor: %d contacts: %s:%d: %s\n",         \
+                (int)(Contacts), __FILE__, __LINE__, #Condition);           \
+            gFailures++;                                                    \
+        }                                                                   \
+    } while (0)
+
+//
+// An input field of the finger report, Contact is the index of the
+// logical collection holding it, or -1 outside of the contacts
+//
+typedef struct _DESCRIPTOR_FIELD
+{
+	USHORT UsagePage;
+	USHORT Usage;
+	LONG Contact;
+	ULONG BitOffset;
+	ULONG BitSize;
+} DESCRIPTOR_FIELD;
+
+typedef struct _DESCRIPTOR_LAYOUT
+{
+	ULONG InputBits[256];
+	ULONG FingerContacts;
+	ULONG FingerFieldCount;
+	DESCRIPTOR_FIELD FingerFields[DESCRIPTOR_MAX_FIELDS];
+} DESCRIPTOR_LAYOUT;
+
+static const UCHAR gDescriptor2[] = {
+	ST_FTS_REPORT_DESCRIPTOR(ST_FTS_DIGITIZER_FINGER_CONTACTS_2)
+};
+
+#if TOUCH_MAX_CONTACTS_PER_REPORT >= 5
+static const UCHAR gDescriptor5[] = {
+	ST_FTS_REPORT_DESCRIPTOR(ST_FTS_DIGITIZER_FINGER_CONTACTS_5)
+};
+#endif
+
+#if TOUCH_MAX_CONTACTS_PER_REPORT >= 10
+static const UCHAR gDescriptor10[] = {
+	ST_FTS_REPORT_DESCRIPTOR(ST_FTS_DIGITIZER_FINGER_CONTACTS_10)
+};
+#endif
+
+static VOID
+DescriptorParse(
+	IN const UCHAR* Descriptor,
+	IN ULONG Length,
+	OUT DESCRIPTOR_LAYOUT* Layout
+)
+{
+	static const ULONG itemSizes[4] = { 0, 1, 2, 4 };
+	ULONG usagePage = 0;
+	ULONG reportSize = 0;
+	ULONG reportCount = 0;
+	ULONG reportId = 0;
+	ULONG usage = 0;
+	ULONG usages = 0;
+	ULONG depth = 0;
+	ULONG contactDepth = 0;
+	LONG contact = -1;
+	ULONG offset = 0;
+	ULONG size;
+	ULONG data;
+	ULONG i;
+	UCHAR prefix;
+	DESCRIPTOR_FIELD* field;
+
+	RtlZeroMemory(Layout, sizeof(DESCRIPTOR_LAYOUT));
+
+	while (offset < Length)
+	{
+		prefix = Descriptor[offset++];
+		size = itemSizes[prefix & 0x03];
+		data = 0;
+
+		for (i = 0; i < size && offset < Length; i++)
+		{
+			data |= (ULONG)Descriptor[offset++] << (8 * i);
+		}
+
+		switch (prefix & 0xFC)
+		{
+		case USAGE_PAGE & 0xFC:
+			usagePage = data;
+			break;
+		case REPORT_SIZE & 0xFC:
+			reportSize = data;
+			break;
+		case REPORT_COUNT & 0xFC:
+			reportCount = data;
+			break;
+		case REPORT_ID & 0xFC:
+			reportId = data & 0xFF;
+			break;
+		case USAGE & 0xFC:
+			usage = data;
+			usages++;
+			break;
+		case BEGIN_COLLECTION & 0xFC:
+			depth++;
+
+			//
+			// Every finger contact is a logical collection of the finger
+			// report
+			//
+			if (reportId == REPORTID_FINGER && data == 0x02 && contactDepth == 0)
+			{
+				contactDepth = depth;
+				contact = (LONG)Layout->FingerContacts++;
+			}
+
+			usages = 0;
+			break;
+		case END_COLLECTION & 0xFC:
+			if (depth == contactDepth)
+			{
+				contactDepth = 0;
+				contact = -1;
+			}
+
+			depth--;
+			usages = 0;
+			break;
+		case INPUT & 0xFC:
+			//
+			// Data fields each carry their own usage, constant ones pad
+			//
+			if (reportId == REPORTID_FINGER &&
+				!(data & 0x01) &&
+				usages == 1 &&
+				Layout->FingerFieldCount < DESCRIPTOR_MAX_FIELDS)
+			{
+				field = &Layout->FingerFields[Layout->FingerFieldCount++];
+				field->UsagePage = (USHORT)usagePage;
+				field->Usage = (USHORT)usage;
+				field->Contact = contact;
+				field->BitOffset = Layout->InputBits[reportId];
+				field->BitSize = reportSize * reportCount;
+			}
+
+			Layout->InputBits[reportId] += reportSize * reportCount;
+			usages = 0;
+			break;
+		default:
+			if ((prefix & 0x0C) == 0x00)
+			{
+				usages = 0;
+			}
+			break;
+		}
+	}
+}
+
+static const DESCRIPTOR_FIELD*
+DescriptorFindField(
+	IN const DESCRIPTOR_LAYOUT* Layout,
+	IN USHORT UsagePage,
+	IN USHORT Usage,
+	IN LONG Contact
+)
+{
+	ULONG i;
+
+	for (i = 0; i < Layout->FingerFieldCount; i++)
+	{
+		if (Layout->FingerFields[i].UsagePage == UsagePage &&
+			Layout->FingerFields[i].Usage == Usage &&
+			Layout->FingerFields[i].Contact == Contact)
+		{
+			return &Layout->FingerFields[i];
+		}
+	}
+
+	return NULL;
+}
+
+static ULONG
+DescriptorFirstBit(
+	IN const HID_TOUCH_FINGER* Finger
+)
+{
+	const UCHAR* bytes = (const UCHAR*)Finger;
+	ULONG bit;
+
+	for (bit = 0; bit < 8 * sizeof(HID_TOUCH_FINGER); bit++)
+	{
+		if (bytes[bit / 8] & (1 << (bit % 8)))
+		{
+			return bit;
+		}
+	}
+
+	return MAXULONG;
+}
+
+static VOID
+DescriptorCheckField(
+	IN const DESCRIPTOR_LAYOUT* Layout,
+	IN ULONG ContactsPerReport,
+	IN USHORT UsagePage,
+	IN USHORT Usage,
+	IN LONG Contact,
+	IN ULONG BitOffset,
+	IN ULONG BitSize
+)
+{
+	const DESCRIPTOR_FIELD* field = DescriptorFindField(Layout, UsagePage, Usage, Contact);
+
+	DESCRIPTOR_CHECK(ContactsPerReport, field != NULL);
+
+	if (field == NULL)
+	{
+		fprintf(stderr, "descriptor: no usage 0x%02X:0x%02X for contact %d\n", UsagePage, Usage, (int)Contact);
+		return;
+	}
+
+	if (field->BitOffset != BitOffset || field->BitSize != BitSize)
+	{
+		fprintf(
+			stderr,
+			"descriptor: usage 0x%02X:0x%02X of contact %d at bit %u size %u, the report has it at bit %u size %u\n",
+			UsagePage,
+			Usage,
+			(int)Contact,
+			field->BitOffset,
+			field->BitSize,
+			BitOffset,
+			BitSize);
+	}
+
+	DESCRIPTOR_CHECK(ContactsPerReport, field->BitOffset == BitOffset);
+	DESCRIPTOR_CHECK(ContactsPerReport, field->BitSize == BitSize);
+}
+
+static VOID
+DescriptorCheckVariant(
+	IN ULONG ContactsPerReport,
+	IN const UCHAR* Descriptor,
+	IN ULONG Length
+)
+{
+	static DESCRIPTOR_LAYOUT layout;
+	HID_INPUT_REPORT report;
+	HID_TOUCH_FINGER finger;
+	ULONG fingerBits = 8 * sizeof(HID_TOUCH_FINGER);
+	ULONG tipSwitchBit;
+	ULONG inRangeBit;
+	ULONG confidenceBit;
+	ULONG countOffset;
+	ULONG c;
+
+	DescriptorParse(Descriptor, Length, &layout);
+
+	RtlZeroMemory(&finger, sizeof(finger));
+	finger.TipSwitch = 1;
+	tipSwitchBit = DescriptorFirstBit(&finger);
+
+	RtlZeroMemory(&finger, sizeof(finger));
+	finger.InRange = 1;
+	inRangeBit = DescriptorFirstBit(&finger);
+
+	RtlZeroMemory(&finger, sizeof(finger));
+	finger.Confidence = 1;
+	confidenceBit = DescriptorFirstBit(&finger);
+
+	//
+	// The finger report is ContactsPerReport contacts followed by the
+	// contact count, right after the report ID
+	//
+	DESCRIPTOR_CHECK(ContactsPerReport, FIELD_OFFSET(HID_INPUT_REPORT, TouchReport) == sizeof(UCHAR));
+	DESCRIPTOR_CHECK(ContactsPerReport, layout.FingerContacts == ContactsPerReport);
+	DESCRIPTOR_CHECK(ContactsPerReport, layout.InputBits[REPORTID_FINGER] ==
+		8 * (ContactsPerReport * sizeof(HID_TOUCH_FINGER) + sizeof(UCHAR)));
+
+	for (c = 0; c < ContactsPerReport; c++)
+	{
+		DescriptorCheckField(&layout, ContactsPerReport, 0x0D, 0x42, c, c * fingerBits + tipSwitchBit, 1);
+		DescriptorCheckField(&layout, ContactsPerReport, 0x0D, 0x32, c, c * fingerBits + inRangeBit, 1);
+		DescriptorCheckField(&layout, ContactsPerReport, 0x0D, 0x47, c, c * fingerBits + confidenceBit, 1);
+		DescriptorCheckField(&layout, ContactsPerReport, 0x0D, 0x51, c,
+			c * fingerBits + 8 * FIELD_OFFSET(HID_TOUCH_FINGER, ContactID), 8);
+		DescriptorCheckField(&layout, ContactsPerReport, 0x01, 0x30, c,
+			c * fingerBits + 8 * FIELD_OFFSET(HID_TOUCH_FINGER, X), 16);
+		DescriptorCheckField(&layout, ContactsPerReport, 0x01, 0x31, c,
+			c * fingerBits + 8 * FIELD_OFFSET(HID_TOUCH_FINGER, Y), 16);
+	}
+
+	RtlZeroMemory(&report, sizeof(report));
+	countOffset = (ULONG)((PUCHAR)&HID_TOUCH_REPORT_CONTACT_COUNT(&report.TouchReport, ContactsPerReport) -
+		(PUCHAR)&report.TouchReport);
+
+	DescriptorCheckField(&layout, ContactsPerReport, 0x0D, 0x54, -1, 8 * countOffset, 8);
+
+	DESCRIPTOR_CHECK(ContactsPerReport, layout.InputBits[REPORTID_KEYPAD] == 8 * sizeof(HID_KEY_REPORT));
+
+	//
+	// HID_INPUT_REPORT holds the largest finger report
+	//
+	DESCRIPTOR_CHECK(ContactsPerReport,
+		sizeof(UCHAR) + layout.InputBits[REPORTID_FINGER] / 8 <= sizeof(HID_INPUT_REPORT));
+}
+
+int
+main(
+	void
+)
+{
+	DescriptorCheckVariant(2, gDescriptor2, sizeof(gDescriptor2));
+#if TOUCH_MAX_CONTACTS_PER_REPORT >= 5
+	DescriptorCheckVariant(5, gDescriptor5, sizeof(gDescriptor5));
+#endif
+#if TOUCH_MAX_CONTACTS_PER_REPORT >= 10
+	DescriptorCheckVariant(10, gDescriptor10, sizeof(gDescriptor10));
+#endif
+
+	return gFailures != 0;
+}
@@ -0,0 +1,262 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		multidevice.c
+
+	Abstract:
+
+		Drives two host devices from separate threads at the same time and
+		checks that every report a device completes is one of its own and
+		that the report ring of one device overflowing leaves the other
+		untouched
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <hostshim.h>
+
+#define MULTIDEVICE_INTERRUPTS     5000
+#define MULTIDEVICE_MOTIONS        4
+#define MULTIDEVICE_X_RANGE        100
+
+typedef struct _MULTIDEVICE_RUN
+{
+	HOST_DEVICE Device;
+	const char* Name;
+	BYTE TouchId;
+	USHORT XBase;
+	ULONG ReadEvery;
+
+	ULONG Reports;
+	ULONG ForeignReports;
+	BOOLEAN LastWasLift;
+} MULTIDEVICE_RUN;
+
+static VOID
+MultiDeviceCheckReports(
+	IN MULTIDEVICE_RUN* Run
+)
+{
+	WDFQUEUE queue = Run->Device.ReportContext.PingPongQueue;
+	const HOST_REPORT* report;
+	const HID_TOUCH_FINGER* contact;
+	ULONG i;
+	ULONG c;
+
+	for (i = 0; i < HostQueueReportCount(queue); i++)
+	{
+		report = HostQueueReport(queue, i);
+		Run->Reports++;
+
+		if (report->Report.ReportID != REPORTID_FINGER)
+		{
+			Run->ForeignReports++;
+			continue;
+		}
+
+		Run->LastWasLift = FALSE;
+
+		for (c = 0; c < report->ContactsPerReport; c++)
+		{
+			contact = &report->Report.TouchReport.Contacts[c];
+
+			if (!contact->Confidence)
+			{
+				continue;
+			}
+
+			if (contact->ContactID != Run->TouchId)
+			{
+				Run->ForeignReports++;
+			}
+			else if (!contact->TipSwitch)
+			{
+				Run->LastWasLift = TRUE;
+			}
+			else if (contact->X < Run->XBase || contact->X >= Run->XBase + MULTIDEVICE_X_RANGE)
+			{
+				Run->ForeignReports++;
+			}
+		}
+	}
+
+	HostQueueClearReports(queue);
+}
+
+static VOID
+MultiDeviceInterrupt(
+	IN MULTIDEVICE_RUN* Run,
+	IN BYTE EventId,
+	IN ULONG Events,
+	IN ULONG Step
+)
+{
+	BYTE event[FIFO_EVENT_SIZE];
+	ULONG i;
+
+	for (i = 0; i < Events; i++)
+	{
+		HostFtsBuildPointerEvent(
+			event,
+			EventId,
+			Run->TouchId,
+			(USHORT)(Run->XBase + (Step + i) % MULTIDEVICE_X_RANGE),
+			500,
+			0x20,
+			1);
+
+		HostFtsChipPushEvent(&Run->Device.Chip, event);
+	}
+
+	HostDeviceInterrupt(&Run->Device);
+}
+
+static void*
+MultiDeviceThread(
+	void* Context
+)
+{
+	MULTIDEVICE_RUN* run = Context;
+	ULONG64 due;
+	ULONG i;
+
+	MultiDeviceInterrupt(run, EVENTID_ENTER_POINTER, 1, 0);
+	HostDeviceRead(&run->Device, REPORT_RING_SIZE);
+
+	for (i = 1; i <= MULTIDEVICE_INTERRUPTS; i++)
+	{
+		MultiDeviceInterrupt(run, EVENTID_MOTION_POINTER, MULTIDEVICE_MOTIONS, i);
+
+		//
+		// The re-report timer of each device runs alongside its
+		// interrupts, and the other device
+		//
+		if (HostTimerQueued(run->Device.ReportContext.ReReportTimer, &due))
+		{
+			HostTimerFire(run->Device.ReportContext.ReReportTimer);
+		}
+
+		if (i % run->ReadEvery == 0)
+		{
+			HostDeviceRead(&run->Device, REPORT_RING_SIZE);
+			MultiDeviceCheckReports(run);
+		}
+	}
+
+	MultiDeviceInterrupt(run, EVENTID_LEAVE_POINTER, 1, 0);
+	HostDeviceRead(&run->Device, REPORT_RING_SIZE);
+	MultiDeviceCheckReports(run);
+
+	return NULL;
+}
+
+int
+main(
+	void
+)
+{
+	static MULTIDEVICE_RUN runs[2] =
+	{
+		//
+		// HIDClass keeps up with the first device but only reads the
+		// second every 64 interrupts, overflowing its report ring
+		//
+		{ .Name = "first", .TouchId = 2, .XBase = 100, .ReadEvery = 1 },
+		{ .Name = "second", .TouchId = 5, .XBase = 800, .ReadEvery = 64 },
+	};
+	pthread_t threads[2];
+	NTSTATUS status;
+	int failures = 0;
+	ULONG i;
+
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, L"TouchPhysicalWidth", 1080);
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, L"TouchPhysicalHeight", 1920);
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, L"TouchPillarBoxWidthLeft", 0);
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, L"TouchPillarBoxWidthRight", 0);
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, L"TouchLetterBoxHeightTop", 0);
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, L"TouchLetterBoxHeightBottom", 0);
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, L"DisplayPhysicalWidth", 1080);
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, L"DisplayPhysicalHeight", 1920);
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, L"TouchHardwareLacksContinuousReporting", 1);
+
+	for (i = 0; i < 2; i++)
+	{
+		status = HostDeviceCreate(&runs[i].Device, FTS_CHIP_FAMILY_FTM4);
+
+		if (!NT_SUCCESS(status))
+		{
+			fprintf(stderr, "multidevice: could not create the %s device - 0x%08X\n", runs[i].Name, (unsigned)status);
+			return 1;
+		}
+	}
+
+	for (i = 0; i < 2; i++)
+	{
+		pthread_create(&threads[i], NULL, MultiDeviceThread, &runs[i]);
+	}
+
+	for (i = 0; i < 2; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+
+	for (i = 0; i < 2; i++)
+	{
+		REPORT_RING* ring = &runs[i].Device.ReportContext.Ring;
+
+		printf(
+			"%s device: %u reports, %u foreign, %u dropped, %u lift-offs lost\n",
+			runs[i].Name,
+			runs[i].Reports,
+			runs[i].ForeignReports,
+			ring->DroppedReports,
+			ring->LostLiftOffs);
+
+		if (runs[i].ForeignReports != 0)
+		{
+			fprintf(stderr, "multidevice: the %s device completed reports of the other one\n", runs[i].Name);
+			failures++;
+		}
+
+		if (!runs[i].LastWasLift || ring->LostLiftOffs != 0)
+		{
+			fprintf(stderr, "multidevice: the %s device lost its lift-off\n", runs[i].Name);
+			failures++;
+		}
+	}
+
+	if (runs[0].Device.ReportContext.Ring.DroppedReports != 0 ||
+		runs[0].Reports < MULTIDEVICE_INTERRUPTS + 2)
+	{
+		fprintf(stderr, "multidevice: the first device lost reports to the other one's overflow\n");
+		failures++;
+	}
+
+	if (runs[1].Device.ReportContext.Ring.DroppedReports == 0)
+	{
+		fprintf(stderr, "multidevice: the report ring of the second device did not overflow\n");
+		failures++;
+	}
+
+	for (i = 0; i < 2; i++)
+	{
+		HostDeviceDestroy(&runs[i].Device);
+	}
+
+	if (HostPoolOutstanding() != 0)
+	{
+		fprintf(stderr, "multidevice: %d pool allocations leaked\n", HostPoolOutstanding());
+		failures++;
+	}
+
+	return failures != 0;
+}
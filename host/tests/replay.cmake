@@ -0,0 +1,30 @@
+#
+# Runs ftsreplay on one trace and compares the reports it prints with the
+# expected ones. Every regular expression of STATISTICS must match the
+# statistics printed at the end of the replay.
+#
+# Input: REPLAY, ARGS, INPUT, EXPECTED, STATISTICS
+#
+
+execute_process(
+	COMMAND ${REPLAY} --statistics ${ARGS} ${INPUT}
+	OUTPUT_VARIABLE output
+	ERROR_VARIABLE statistics
+	RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "ftsreplay failed (${result}):\n${statistics}")
+endif()
+
+file(READ ${EXPECTED} expected)
+
+if(NOT output STREQUAL expected)
+	message(FATAL_ERROR "Reports differ from ${EXPECTED}\n--- expected\n${expected}--- got\n${output}")
+endif()
+
+foreach(pattern ${STATISTICS})
+	if(NOT statistics MATCHES "${pattern}")
+		message(FATAL_ERROR "Statistics do not match '${pattern}':\n${statistics}")
+	endif()
+endforeach()
@@ -0,0 +1,144 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		resync.c
+
+	Abstract:
+
+		Checks that TchClearObjectInterrupts discards what it drains: a
+		full FIFO or a failed read while clearing the interrupts must not
+		resynchronize, and flush the events of, the first live interrupt
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#include <stdio.h>
+#include <hostshim.h>
+
+static int gFailures;
+
+#define RESYNC_CHECK(Condition)                                             \
+    do {                                                                    \
+        if (!(Condition)) {                                                 \
+            fprintf(stderr, "resync: %s:%d: %s\n", __FILE__, __LINE__, #Condition); \
+            gFailures++;                                                    \
+        }                                                                   \
+    } while (0)
+
+static VOID
+ResyncPushMotions(
+	IN HOST_DEVICE* Device,
+	IN ULONG Count
+)
+{
+	BYTE event[FIFO_EVENT_SIZE];
+	ULONG i;
+
+	for (i = 0; i < Count; i++)
+	{
+		HostFtsBuildPointerEvent(event, EVENTID_MOTION_POINTER, 0, (USHORT)(100 + i), 100, 0x20, 1);
+		HostFtsChipPushEvent(&Device->Chip, event);
+	}
+}
+
+static VOID
+ResyncCheckLiveInterrupt(
+	IN HOST_DEVICE* Device
+)
+{
+	WDFQUEUE queue = Device->ReportContext.PingPongQueue;
+	BYTE event[FIFO_EVENT_SIZE];
+	const HOST_REPORT* report;
+
+	RESYNC_CHECK(!Device->TouchContext->ResyncPending);
+
+	HostFtsBuildPointerEvent(event, EVENTID_ENTER_POINTER, 3, 500, 500, 0x20, 1);
+	HostFtsChipPushEvent(&Device->Chip, event);
+
+	HostDeviceInterrupt(Device);
+	HostDeviceRead(Device, REPORT_RING_SIZE);
+
+	//
+	// The contact is reported down and nothing was flushed
+	//
+	RESYNC_CHECK(Device->Chip.Flushes == 0);
+	RESYNC_CHECK(Device->TouchContext->FifoResyncs == 0);
+	RESYNC_CHECK(HostQueueReportCount(queue) == 1);
+
+	if (HostQueueReportCount(queue) == 1)
+	{
+		report = HostQueueReport(queue, 0);
+
+		RESYNC_CHECK(report->Report.ReportID == REPORTID_FINGER);
+		RESYNC_CHECK(report->Report.TouchReport.Contacts[0].ContactID == 3);
+		RESYNC_CHECK(report->Report.TouchReport.Contacts[0].TipSwitch);
+	}
+
+	HostQueueClearReports(queue);
+}
+
+static VOID
+ResyncClearFullFifo(
+	VOID
+)
+{
+	HOST_DEVICE device;
+
+	RESYNC_CHECK(NT_SUCCESS(HostDeviceCreate(&device, FTS_CHIP_FAMILY_FTM4)));
+
+	//
+	// Events keep arriving while the device is stopped, filling the FIFO
+	//
+	ResyncPushMotions(&device, FIFO_DEPTH + 6);
+
+	RESYNC_CHECK(NT_SUCCESS(TchClearObjectInterrupts(device.TouchContext, &device.I2CContext)));
+	RESYNC_CHECK(device.TouchContext->FifoOverflows == 1);
+	RESYNC_CHECK(device.Chip.FifoCount == 0);
+
+	ResyncCheckLiveInterrupt(&device);
+
+	HostDeviceDestroy(&device);
+}
+
+static VOID
+ResyncClearFailedRead(
+	VOID
+)
+{
+	HOST_DEVICE device;
+
+	RESYNC_CHECK(NT_SUCCESS(HostDeviceCreate(&device, FTS_CHIP_FAMILY_FTM4)));
+
+	//
+	// More events than the speculative batch, the read of the others
+	// fails
+	//
+	ResyncPushMotions(&device, device.TouchContext->FifoSpeculativeEvents + 8);
+	device.Chip.FailRead = device.Chip.Reads + 2;
+
+	TchClearObjectInterrupts(device.TouchContext, &device.I2CContext);
+
+	ResyncCheckLiveInterrupt(&device);
+
+	HostDeviceDestroy(&device);
+}
+
+int
+main(
+	void
+)
+{
+	ResyncClearFullFifo();
+	ResyncClearFailedRead();
+
+	RESYNC_CHECK(HostPoolOutstanding() == 0);
+
+	return gFailures != 0;
+}
@@ -0,0 +1,723 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		ftsreplay.c
+
+	Abstract:
+
+		Replays recorded FTS FIFO events through the event pipeline of a
+		host device and prints the HID input reports it produces
+
+		The events are read from a text file, one 8-byte event per line
+		written as hex bytes, a blank line ending the events of one
+		interrupt and '#' starting a comment. With --binary the file holds
+		raw 8-byte events, --events-per-interrupt of them per interrupt.
+
+	Environment:
+
+		User mode, host build only
+
+	Revision History:
+
+--*/
+
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <hostshim.h>
+
+#define REPLAY_COUNT(Array) (sizeof(Array) / sizeof((Array)[0]))
+
+typedef struct _REPLAY_OPTIONS
+{
+	BOOLEAN Binary;
+	ULONG EventsPerInterrupt;
+	ULONG ReadsPerInterrupt;
+	ULONG64 Interval;
+	BOOLEAN Timestamps;
+	BOOLEAN Statistics;
+	FTS_CHIP_FAMILY ChipFamily;
+	LONG SpeculativeEvents;
+	LONG CoalesceReports;
+	ULONG FailRead;
+} REPLAY_OPTIONS;
+
+typedef struct _REPLAY_STATE
+{
+	HOST_DEVICE Device;
+	REPLAY_OPTIONS Options;
+	ULONG Interrupts;
+	ULONG Events;
+	ULONG ReportsPrinted;
+	ULONG64 Elapsed;
+} REPLAY_STATE;
+
+static ULONG64
+ReplayNow(
+	VOID
+)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (ULONG64)now.tv_sec * 1000000000ULL + (ULONG64)now.tv_nsec;
+}
+
+static VOID
+ReplayPrintReport(
+	IN ULONG Interrupt,
+	IN const char* Source,
+	IN BOOLEAN Timestamp,
+	IN const HOST_REPORT* HostReport
+)
+{
+	const HID_INPUT_REPORT* report = &HostReport->Report;
+	const HID_TOUCH_FINGER* contact;
+	ULONG i;
+
+	printf("%u%s", Interrupt, Source);
+
+	if (Timestamp)
+	{
+		printf(" @%lluus", (unsigned long long)(HostReport->Timestamp / 10));
+	}
+
+	printf(": ");
+
+	switch (report->ReportID)
+	{
+	case REPORTID_FINGER:
+		printf(
+			"finger count=%u",
+			HID_TOUCH_REPORT_CONTACT_COUNT(&report->TouchReport, HostReport->ContactsPerReport));
+
+		for (i = 0; i < HostReport->ContactsPerReport; i++)
+		{
+			contact = &report->TouchReport.Contacts[i];
+
+			if (!contact->Confidence)
+			{
+				continue;
+			}
+
+			printf(
+				" [id=%u tip=%u x=%u y=%u]",
+				contact->ContactID,
+				contact->TipSwitch,
+				contact->X,
+				contact->Y);
+		}
+		break;
+
+	case REPORTID_STYLUS:
+		printf(
+			"pen tip=%u barrel=%u invert=%u eraser=%u range=%u x=%u y=%u pressure=%u",
+			report->PenReport.TipSwitch,
+			report->PenReport.BarrelSwitch,
+			report->PenReport.Invert,
+			report->PenReport.Eraser,
+			report->PenReport.InRange,
+			report->PenReport.X,
+			report->PenReport.Y,
+			report->PenReport.TipPressure);
+		break;
+
+	case REPORTID_KEYPAD:
+		printf(
+			"keypad back=%u start=%u search=%u power=%u",
+			report->KeyReport.ACBack,
+			report->KeyReport.Start,
+			report->KeyReport.ACSearch,
+			report->KeyReport.SystemPowerDown);
+		break;
+
+	default:
+		printf("report id=%u", report->ReportID);
+		break;
+	}
+
+	printf("\n");
+}
+
+static ULONG
+ReplayReads(
+	IN REPLAY_STATE* State
+)
+{
+	//
+	// Without a limit HIDClass keeps enough reads pending for every
+	// buffered report
+	//
+	return State->Options.ReadsPerInterrupt != 0 ?
+		State->Options.ReadsPerInterrupt :
+		REPORT_RING_SIZE;
+}
+
+static VOID
+ReplayDeliverReports(
+	IN REPLAY_STATE* State,
+	IN const char* Source,
+	IN ULONG Reads
+)
+{
+	WDFQUEUE queue = State->Device.ReportContext.PingPongQueue;
+
+	HostDeviceRead(&State->Device, Reads);
+
+	while (State->ReportsPrinted < HostQueueReportCount(queue))
+	{
+		ReplayPrintReport(
+			State->Interrupts,
+			Source,
+			State->Options.Timestamps,
+			HostQueueReport(queue, State->ReportsPrinted));
+		State->ReportsPrinted++;
+	}
+
+	HostQueueClearReports(queue);
+	State->ReportsPrinted = 0;
+
+	//
+	// Reads HIDClass did not get reports for are not kept around
+	//
+	while (HostQueuePendingReads(queue) != 0)
+	{
+		WDFREQUEST request;
+		WdfIoQueueRetrieveNextRequest(queue, &request);
+	}
+}
+
+static VOID
+ReplayAdvanceTime(
+	IN REPLAY_STATE* State,
+	IN ULONG64 Until
+)
+{
+	ULONG64 due;
+
+	//
+	// Run the re-report timer for every interval it comes due in
+	//
+	while (HostTimerQueued(State->Device.ReportContext.ReReportTimer, &due) &&
+		due <= Until)
+	{
+		HostClockSet(max(due, KeQueryInterruptTime()));
+		HostTimerFire(State->Device.ReportContext.ReReportTimer);
+		ReplayDeliverReports(State, " timer", ReplayReads(State));
+	}
+
+	HostClockSet(Until);
+}
+
+static NTSTATUS
+ReplayInterrupt(
+	IN REPLAY_STATE* State,
+	IN BYTE* Events,
+	IN ULONG EventCount
+)
+{
+	NTSTATUS status;
+	ULONG64 start;
+	ULONG i;
+
+	if (State->Options.Interval != 0)
+	{
+		ReplayAdvanceTime(State, KeQueryInterruptTime() + State->Options.Interval);
+	}
+
+	State->Interrupts++;
+	State->Events += EventCount;
+
+	for (i = 0; i < EventCount; i++)
+	{
+		HostFtsChipPushEvent(&State->Device.Chip, Events + i * FIFO_EVENT_SIZE);
+	}
+
+	start = ReplayNow();
+	status = HostDeviceInterrupt(&State->Device);
+	State->Elapsed += ReplayNow() - start;
+
+	if (!NT_SUCCESS(status))
+	{
+		fprintf(stderr, "ftsreplay: interrupt %u failed - 0x%08X\n", State->Interrupts, (unsigned)status);
+	}
+
+	ReplayDeliverReports(State, "", ReplayReads(State));
+
+	return status;
+}
+
+static int
+ReplayParseHexLine(
+	IN const char* Line,
+	OUT BYTE* Event
+)
+{
+	ULONG count = 0;
+	int high = -1;
+	int digit;
+
+	for (; *Line != '\0' && *Line != '#'; Line++)
+	{
+		if (isspace((unsigned char)*Line) || *Line == ',' || *Line == ':')
+		{
+			continue;
+		}
+
+		if (!isxdigit((unsigned char)*Line))
+		{
+			return -1;
+		}
+
+		digit = isdigit((unsigned char)*Line) ? *Line - '0' : tolower((unsigned char)*Line) - 'a' + 10;
+
+		if (high < 0)
+		{
+			high = digit;
+			continue;
+		}
+
+		if (count == FIFO_EVENT_SIZE)
+		{
+			return -1;
+		}
+
+		Event[count++] = (BYTE)((high << 4) | digit);
+		high = -1;
+	}
+
+	if (high >= 0 || (count != 0 && count != FIFO_EVENT_SIZE))
+	{
+		return -1;
+	}
+
+	return count != 0;
+}
+
+static int
+ReplayText(
+	IN REPLAY_STATE* State,
+	IN FILE* File
+)
+{
+	BYTE events[FIFO_DEPTH * 4 * FIFO_EVENT_SIZE];
+	ULONG count = 0;
+	ULONG lineNumber = 0;
+	char line[256];
+	int parsed;
+
+	while (fgets(line, sizeof(line), File) != NULL)
+	{
+		lineNumber++;
+
+		parsed = ReplayParseHexLine(line, events + count * FIFO_EVENT_SIZE);
+
+		if (parsed < 0)
+		{
+			fprintf(stderr, "ftsreplay: line %u is not an 8-byte event\n", lineNumber);
+			return 1;
+		}
+
+		if (parsed > 0)
+		{
+			if (++count == REPLAY_COUNT(events))
+			{
+				fprintf(stderr, "ftsreplay: too many events in the interrupt ending on line %u\n", lineNumber);
+				return 1;
+			}
+
+			continue;
+		}
+
+		//
+		// Comment lines do not end an interrupt, blank lines do
+		//
+		if (strchr(line, '#') == NULL && count != 0)
+		{
+			ReplayInterrupt(State, events, count);
+			count = 0;
+		}
+	}
+
+	if (count != 0)
+	{
+		ReplayInterrupt(State, events, count);
+	}
+
+	return 0;
+}
+
+static int
+ReplayBinary(
+	IN REPLAY_STATE* State,
+	IN FILE* File
+)
+{
+	BYTE events[FIFO_DEPTH * 4 * FIFO_EVENT_SIZE];
+	ULONG perInterrupt = State->Options.EventsPerInterrupt;
+	size_t count;
+
+	if (perInterrupt > REPLAY_COUNT(events))
+	{
+		fprintf(stderr, "ftsreplay: at most %u events per interrupt\n", (unsigned)REPLAY_COUNT(events));
+		return 1;
+	}
+
+	while ((count = fread(events, FIFO_EVENT_SIZE, perInterrupt, File)) != 0)
+	{
+		ReplayInterrupt(State, events, (ULONG)count);
+	}
+
+	return 0;
+}
+
+static VOID
+ReplayPrintPercentiles(
+	IN const char* Stage,
+	IN const ULONG* Buckets
+)
+{
+	static const ULONG percentiles[] = { 500, 990, 999 };
+	ULONG64 total = 0;
+	ULONG64 seen;
+	ULONG bucket;
+	ULONG i;
+
+	for (bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++)
+	{
+		total += Buckets[bucket];
+	}
+
+	fprintf(stderr, "  %-16s %8llu samples", Stage, (unsigned long long)total);
+
+	for (i = 0; i < REPLAY_COUNT(percentiles) && total != 0; i++)
+	{
+		seen = 0;
+
+		for (bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++)
+		{
+			seen += Buckets[bucket];
+
+			if (seen * 1000 >= total * percentiles[i])
+			{
+				break;
+			}
+		}
+
+		//
+		// Bucket i holds samples below 2^i microseconds
+		//
+		fprintf(stderr, "  p%g < %lu us", percentiles[i] / 10.0, 1UL << bucket);
+	}
+
+	fprintf(stderr, "\n");
+}
+
+static VOID
+ReplayPrintStatistics(
+	IN REPLAY_STATE* State,
+	IN LONG Allocations
+)
+{
+	static const char* stages[LATENCY_STAGE_COUNT] =
+	{
+		"fifo read",
+		"decode",
+		"report queued",
+		"report completed",
+	};
+	ULONG counts[LATENCY_STAGE_COUNT * LATENCY_HISTOGRAM_BUCKETS];
+	HOST_FTS_CHIP* chip = &State->Device.Chip;
+	FTS_CONTROLLER_CONTEXT* touch = State->Device.TouchContext;
+	REPORT_RING* ring = &State->Device.ReportContext.Ring;
+	ULONG interrupts = max(State->Interrupts, 1);
+	ULONG stage;
+
+	fprintf(stderr, "interrupts %u, events %u\n", State->Interrupts, State->Events);
+	fprintf(
+		stderr,
+		"bus: %u reads, %u writes, %u bytes read, %u bytes written, %.2f transactions per interrupt\n",
+		chip->Reads,
+		chip->Writes,
+		chip->BytesRead,
+		chip->BytesWritten,
+		(double)(chip->Reads + chip->Writes) / interrupts);
+	fprintf(
+		stderr,
+		"chip: %u interrupt enable writes, %u flushes\n",
+		chip->InterruptEnableWrites,
+		chip->Flushes);
+	fprintf(
+		stderr,
+		"fifo: %u events lost, %u overflows detected, %u resyncs\n",
+		chip->LostEvents,
+		touch->FifoOverflows,
+		touch->FifoResyncs);
+	fprintf(
+		stderr,
+		"ring: %u reports dropped, %u lift-offs lost\n",
+		ring->DroppedReports,
+		ring->LostLiftOffs);
+	fprintf(
+		stderr,
+		"pool: %d allocations while replaying\n",
+		Allocations);
+	fprintf(
+		stderr,
+		"cpu: %.0f ns per interrupt\n",
+		(double)State->Elapsed / interrupts);
+
+	LatencyReadHistogram(&State->Device.ReportContext.Latency, counts, FALSE);
+
+	fprintf(stderr, "latency:\n");
+
+	for (stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+	{
+		ReplayPrintPercentiles(stages[stage], counts + stage * LATENCY_HISTOGRAM_BUCKETS);
+	}
+}
+
+static VOID
+ReplayUsage(
+	VOID
+)
+{
+	fprintf(
+		stderr,
+		"usage: ftsreplay [options] FILE\n"
+		"  -b, --binary                 FILE holds raw 8-byte events\n"
+		"  -n, --events-per-interrupt N events per interrupt with --binary (1)\n"
+		"  -r, --reads N                reads HIDClass posts per interrupt (unlimited)\n"
+		"  -i, --interval US            simulated time between interrupts, fires the\n"
+		"                               re-report timer in between\n"
+		"  -t, --timestamps             print the simulated time of every report\n"
+		"  -f, --family ftm3|ftm4|unknown  simulated chip (ftm4)\n"
+		"  -e, --speculative N          events read in the first FIFO transaction\n"
+		"  -c, --coalesce 0|1           one report per interrupt rather than per event\n"
+		"  -p, --property NAME=VALUE    screen property, as read from the registry\n"
+		"  -x, --fail-read N            fail the Nth bus read of the replay\n"
+		"  -s, --statistics             print statistics to stderr\n");
+}
+
+static BOOLEAN
+ReplaySetProperty(
+	IN const char* Property
+)
+{
+	WCHAR name[128];
+	const char* equals = strchr(Property, '=');
+	size_t length;
+	char* end;
+	unsigned long value;
+
+	if (equals == NULL || equals == Property)
+	{
+		return FALSE;
+	}
+
+	length = (size_t)(equals - Property);
+
+	if (length >= REPLAY_COUNT(name))
+	{
+		return FALSE;
+	}
+
+	value = strtoul(equals + 1, &end, 0);
+
+	if (*end != '\0')
+	{
+		return FALSE;
+	}
+
+	for (size_t i = 0; i < length; i++)
+	{
+		name[i] = (WCHAR)(unsigned char)Property[i];
+	}
+
+	name[length] = L'\0';
+
+	HostRegistrySetValue(TOUCH_SCREEN_PROPERTIES_REG_KEY, name, (ULONG)value);
+
+	return TRUE;
+}
+
+int
+main(
+	int argc,
+	char** argv
+)
+{
+	static const struct option longOptions[] =
+	{
+		{ "binary", no_argument, NULL, 'b' },
+		{ "events-per-interrupt", required_argument, NULL, 'n' },
+		{ "reads", required_argument, NULL, 'r' },
+		{ "interval", required_argument, NULL, 'i' },
+		{ "timestamps", no_argument, NULL, 't' },
+		{ "family", required_argument, NULL, 'f' },
+		{ "speculative", required_argument, NULL, 'e' },
+		{ "coalesce", required_argument, NULL, 'c' },
+		{ "property", required_argument, NULL, 'p' },
+		{ "fail-read", required_argument, NULL, 'x' },
+		{ "statistics", no_argument, NULL, 's' },
+		{ NULL, 0, NULL, 0 }
+	};
+	static REPLAY_STATE state;
+	LONG allocations;
+	NTSTATUS status;
+	FILE* file;
+	int option;
+	int result;
+
+	state.Options.EventsPerInterrupt = 1;
+	state.Options.ChipFamily = FTS_CHIP_FAMILY_FTM4;
+	state.Options.SpeculativeEvents = -1;
+	state.Options.CoalesceReports = -1;
+
+	while ((option = getopt_long(argc, argv, "bn:r:i:tf:e:c:p:x:s", longOptions, NULL)) != -1)
+	{
+		switch (option)
+		{
+		case 'b':
+			state.Options.Binary = TRUE;
+			break;
+		case 'n':
+			state.Options.EventsPerInterrupt = (ULONG)strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			state.Options.ReadsPerInterrupt = (ULONG)strtoul(optarg, NULL, 0);
+			break;
+		case 'i':
+			state.Options.Interval = strtoull(optarg, NULL, 0) * 10;
+			break;
+		case 't':
+			state.Options.Timestamps = TRUE;
+			break;
+		case 'f':
+			if (strcmp(optarg, "ftm3") == 0)
+			{
+				state.Options.ChipFamily = FTS_CHIP_FAMILY_FTM3;
+			}
+			else if (strcmp(optarg, "ftm4") == 0)
+			{
+				state.Options.ChipFamily = FTS_CHIP_FAMILY_FTM4;
+			}
+			else if (strcmp(optarg, "unknown") == 0)
+			{
+				state.Options.ChipFamily = FTS_CHIP_FAMILY_UNKNOWN;
+			}
+			else
+			{
+				ReplayUsage();
+				return 2;
+			}
+			break;
+		case 'e':
+			state.Options.SpeculativeEvents = (LONG)strtol(optarg, NULL, 0);
+			break;
+		case 'c':
+			state.Options.CoalesceReports = (LONG)strtol(optarg, NULL, 0);
+			break;
+		case 'p':
+			if (!ReplaySetProperty(optarg))
+			{
+				ReplayUsage();
+				return 2;
+			}
+			break;
+		case 'x':
+			state.Options.FailRead = (ULONG)strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			state.Options.Statistics = TRUE;
+			break;
+		default:
+			ReplayUsage();
+			return 2;
+		}
+	}
+
+	if (optind != argc - 1 || state.Options.EventsPerInterrupt == 0)
+	{
+		ReplayUsage();
+		return 2;
+	}
+
+	file = fopen(argv[optind], state.Options.Binary ? "rb" : "r");
+
+	if (file == NULL)
+	{
+		perror(argv[optind]);
+		return 1;
+	}
+
+	if (state.Options.Interval != 0)
+	{
+		HostClockSet(0);
+	}
+
+	status = HostDeviceCreate(&state.Device, state.Options.ChipFamily);
+
+	if (!NT_SUCCESS(status))
+	{
+		fprintf(stderr, "ftsreplay: could not create the device - 0x%08X\n", (unsigned)status);
+		fclose(file);
+		return 1;
+	}
+
+	if (state.Options.SpeculativeEvents >= 0)
+	{
+		state.Device.TouchContext->FifoSpeculativeEvents = (DWORD)state.Options.SpeculativeEvents;
+	}
+
+	if (state.Options.CoalesceReports >= 0)
+	{
+		state.Device.TouchContext->CoalesceReports = state.Options.CoalesceReports != 0;
+	}
+
+	//
+	// Start counting from the first interrupt, the device start reads
+	// the FIFO as well
+	//
+	state.Device.Chip.Reads = 0;
+	state.Device.Chip.Writes = 0;
+	state.Device.Chip.BytesRead = 0;
+	state.Device.Chip.BytesWritten = 0;
+	state.Device.Chip.InterruptEnableWrites = 0;
+	state.Device.Chip.Flushes = 0;
+	state.Device.Chip.FailRead = state.Options.FailRead;
+	allocations = HostPoolAllocations();
+
+	result = state.Options.Binary ?
+		ReplayBinary(&state, file) :
+		ReplayText(&state, file);
+
+	//
+	// Let the re-report timer run out once the trace ended and HIDClass
+	// catch up with the reports still buffered
+	//
+	if (state.Options.Interval != 0)
+	{
+		ReplayAdvanceTime(&state, KeQueryInterruptTime() + state.Options.Interval);
+	}
+
+	ReplayDeliverReports(&state, " end", REPORT_RING_SIZE);
+
+	if (state.Options.Statistics)
+	{
+		fflush(stdout);
+		ReplayPrintStatistics(&state, HostPoolAllocations() - allocations);
+	}
+
+	HostDeviceDestroy(&state.Device);
+	fclose(file);
+
+	return result;
+}
@@ -4,6 +4,24 @@
 #pragma once
 
 #define PTP_MAX_CONTACT_POINTS 10
+
+//
+// Finger contacts carried by one REPORTID_FINGER report in hybrid mode.
+// HID_TOUCH_REPORT is sized for the maximum, the variant in use is picked
+// with the ContactsPerReport screen property.
+//
+#ifndef TOUCH_MAX_CONTACTS_PER_REPORT
+#define TOUCH_MAX_CONTACTS_PER_REPORT 10
+#endif
+
+#define TOUCH_DEFAULT_CONTACTS_PER_REPORT 2
+
+#if TOUCH_MAX_CONTACTS_PER_REPORT != 2 && TOUCH_MAX_CONTACTS_PER_REPORT != 5 && TOUCH_MAX_CONTACTS_PER_REPORT != 10
+#error TOUCH_MAX_CONTACTS_PER_REPORT must be 2, 5 or 10
+#endif
+
+#define TOUCH_CONTACTS_PER_REPORT_SUPPORTED(n) \
+	(((n) == 2 || (n) == 5 || (n) == 10) && (n) <= TOUCH_MAX_CONTACTS_PER_REPORT)
 #define PTP_BUTTON_TYPE_CLICK_PAD 0
 #define PTP_BUTTON_TYPE_PRESSURE_PAD 1
 
@@ -10,7 +10,7 @@
 #include <reshub.h>
 #include "trace.h"
 #include "hid.h"
-#include "spb.h"
+#include "spbhelper.h"
 
 //
 // Memory tags
@@ -29,183 +29,122 @@
 //
 // Structures
 //
+//
+// Settings schema, the settings structure, the registry value names and
+// the defaults are all generated from these lists. Every setting is a
+// REG_DWORD value of the Settings key named after the setting.
+//
+#define TOUCH_SETTINGS_VENDOR_COUNT      4
+#define TOUCH_SETTINGS_PRODUCT_ID_COUNT  10
+
+//
+// X(Name, Default) for the settings that apply to the whole device
+//
+#define TOUCH_SETTINGS_GLOBAL(X) \
+	X(DeviceId, 0x1) \
+	X(UseControllerSleep, 0x0) \
+	X(UseNoSleepBit, 0x1) \
+	X(ImprovedTouchSupported, 0x0) \
+	X(WakeupGestureSupported, 0x0) \
+	X(ChargerDetectionSupported, 0x0) \
+	X(ActivePenSupported, 0x0) \
+	X(ExtClockControlSupported, 0x0) \
+	X(ForceDriverSupported, 0x0) \
+	X(DoubleTapMaxTapTime10ms, 0x0) \
+	X(DoubleTapMaxTapDistance100um, 0x3C) \
+	X(DoubleTapDeadZoneWidth100um, 0x32) \
+	X(DoubleTapDeadZoneHeight100um, 0x32) \
+	X(ControllerType, 0x32) \
+	X(VendorCount, 0x1) \
+	X(ResetControllerInWakeUp, 0x0) \
+	X(ForceFlash, 0x0)
+
+//
+// X(Name, Default) for the settings stored once per vendor, the value
+// of vendor NN is named <Name>NN
+//
+#define TOUCH_SETTINGS_PER_VENDOR(X) \
+	X(Vendor, 0xFF) \
+	X(Revision, 0xFF) \
+	X(ReprogramFw, 0xFF)
+
+//
+// X(Name, Default) for the self-test limits of a vendor, the value of
+// vendor NN is named VendorNN<Name>. Product IDs are named
+// VendorNNProductIdN and default to 0.
+//
+#define TOUCH_SETTINGS_VENDOR_TESTS(X) \
+	X(IncludeHighResTest, 0x0) \
+	X(HighResMaxRxLimit, 0x3FFF) \
+	X(HighResMaxTxLimit, 0x3FFF) \
+	X(HighResMinImageLimit, 0x3FFF) \
+	X(IncludeBaselineMinMaxTest, 0x0) \
+	X(BaselineMinMaxMinPixelLimit, 0x3FFF) \
+	X(BaselineMinMaxMaxPixelLimit, 0x3FFF) \
+	X(IncludeFullBaselineTest, 0x0) \
+	X(RxAmount, 0x0) \
+	X(TxAmount, 0x0) \
+	X(RxElectrodeMaskTouch2D, 0x0) \
+	X(TxElectrodeMaskTouch2D, 0x0) \
+	X(RxElectrodeMaskButtons, 0x0) \
+	X(TxElectrodeMaskButtons, 0x0) \
+	X(FullBaselineButton0Min, 0x3FFF) \
+	X(FullBaselineButton1Min, 0x3FFF) \
+	X(FullBaselineButton2Min, 0x3FFF) \
+	X(FullBaselineButton0Max, 0x3FFF) \
+	X(FullBaselineButton1Max, 0x3FFF) \
+	X(FullBaselineButton2Max, 0x3FFF) \
+	X(IncludeAbsSenseRawCapTest, 0x0) \
+	X(AbsSenseRawCapTxRxStart, 0x0) \
+	X(AbsSenseRawCapTxRxEnd, 0x0) \
+	X(AbsSenseRawCapMinLimit, 0x3FFF) \
+	X(AbsSenseRawCapMaxLimit, 0x3FFF) \
+	X(IncludeShortTest, 0x0)
+
+//
+// X(Name, Default, NN, Index) once per vendor, NN being the two digit
+// vendor number used in the value names
+//
+#define TOUCH_SETTINGS_FOR_EACH_VENDOR(X, Name, Default) \
+	X(Name, Default, 00, 0) \
+	X(Name, Default, 01, 1) \
+	X(Name, Default, 02, 2) \
+	X(Name, Default, 03, 3)
+
+//
+// X(NN, Index, N) once per product ID of vendor NN
+//
+#define TOUCH_SETTINGS_FOR_EACH_PRODUCT_ID(X, NN, Index) \
+	X(NN, Index, 0) \
+	X(NN, Index, 1) \
+	X(NN, Index, 2) \
+	X(NN, Index, 3) \
+	X(NN, Index, 4) \
+	X(NN, Index, 5) \
+	X(NN, Index, 6) \
+	X(NN, Index, 7) \
+	X(NN, Index, 8) \
+	X(NN, Index, 9)
+
+#define TOUCH_SETTINGS_FIELD(Name, Default) UINT32 Name;
+#define TOUCH_SETTINGS_VENDOR_FIELD(Name, Default) UINT32 Name[TOUCH_SETTINGS_VENDOR_COUNT];
+
+typedef struct _TOUCH_VENDOR_SETTINGS
+{
+	UINT32 ProductId[TOUCH_SETTINGS_PRODUCT_ID_COUNT];
+	TOUCH_SETTINGS_VENDOR_TESTS(TOUCH_SETTINGS_FIELD)
+} TOUCH_VENDOR_SETTINGS;
+
 typedef struct _TOUCH_SCREEN_SETTINGS
 {
-	UINT32 DeviceId;
-	UINT32 UseControllerSleep;
-	UINT32 UseNoSleepBit;
-	UINT32 ImprovedTouchSupported;
-	UINT32 WakeupGestureSupported;
-	UINT32 ChargerDetectionSupported;
-	UINT32 ActivePenSupported;
-	UINT32 ExtClockControlSupported;
-	UINT32 ForceDriverSupported;
-	UINT32 DoubleTapMaxTapTime10ms;
-	UINT32 DoubleTapMaxTapDistance100um;
-	UINT32 DoubleTapDeadZoneWidth100um;
-	UINT32 DoubleTapDeadZoneHeight100um;
-	UINT32 ControllerType;
-	UINT32 VendorCount;
-	UINT32 ResetControllerInWakeUp;
-	UINT32 Vendor00;
-	UINT32 Vendor01;
-	UINT32 Vendor02;
-	UINT32 Vendor03;
-	UINT32 Revision00;
-	UINT32 Revision01;
-	UINT32 Revision02;
-	UINT32 Revision03;
-	UINT32 ReprogramFw00;
-	UINT32 ReprogramFw01;
-	UINT32 ReprogramFw02;
-	UINT32 ReprogramFw03;
-	UINT32 ForceFlash;
-	UINT32 Vendor00ProductId0;
-	UINT32 Vendor00ProductId1;
-	UINT32 Vendor00ProductId2;
-	UINT32 Vendor00ProductId3;
-	UINT32 Vendor00ProductId4;
-	UINT32 Vendor00ProductId5;
-	UINT32 Vendor00ProductId6;
-	UINT32 Vendor00ProductId7;
-	UINT32 Vendor00ProductId8;
-	UINT32 Vendor00ProductId9;
-	UINT32 Vendor01ProductId0;
-	UINT32 Vendor01ProductId1;
-	UINT32 Vendor01ProductId2;
-	UINT32 Vendor01ProductId3;
-	UINT32 Vendor01ProductId4;
-	UINT32 Vendor01ProductId5;
-	UINT32 Vendor01ProductId6;
-	UINT32 Vendor01ProductId7;
-	UINT32 Vendor01ProductId8;
-	UINT32 Vendor01ProductId9;
-	UINT32 Vendor02ProductId0;
-	UINT32 Vendor02ProductId1;
-	UINT32 Vendor02ProductId2;
-	UINT32 Vendor02ProductId3;
-	UINT32 Vendor02ProductId4;
-	UINT32 Vendor02ProductId5;
-	UINT32 Vendor02ProductId6;
-	UINT32 Vendor02ProductId7;
-	UINT32 Vendor02ProductId8;
-	UINT32 Vendor02ProductId9;
-	UINT32 Vendor03ProductId0;
-	UINT32 Vendor03ProductId1;
-	UINT32 Vendor03ProductId2;
-	UINT32 Vendor03ProductId3;
-	UINT32 Vendor03ProductId4;
-	UINT32 Vendor03ProductId5;
-	UINT32 Vendor03ProductId6;
-	UINT32 Vendor03ProductId7;
-	UINT32 Vendor03ProductId8;
-	UINT32 Vendor03ProductId9;
-	UINT32 Vendor00IncludeHighResTest;
-	UINT32 Vendor00HighResMaxRxLimit;
-	UINT32 Vendor00HighResMaxTxLimit;
-	UINT32 Vendor00HighResMinImageLimit;
-	UINT32 Vendor00IncludeBaselineMinMaxTest;
-	UINT32 Vendor00BaselineMinMaxMinPixelLimit;
-	UINT32 Vendor00BaselineMinMaxMaxPixelLimit;
-	UINT32 Vendor00IncludeFullBaselineTest;
-	UINT32 Vendor00RxAmount;
-	UINT32 Vendor00TxAmount;
-	UINT32 Vendor00RxElectrodeMaskTouch2D;
-	UINT32 Vendor00TxElectrodeMaskTouch2D;
-	UINT32 Vendor00RxElectrodeMaskButtons;
-	UINT32 Vendor00TxElectrodeMaskButtons;
-	UINT32 Vendor00FullBaselineButton0Min;
-	UINT32 Vendor00FullBaselineButton1Min;
-	UINT32 Vendor00FullBaselineButton2Min;
-	UINT32 Vendor00FullBaselineButton0Max;
-	UINT32 Vendor00FullBaselineButton1Max;
-	UINT32 Vendor00FullBaselineButton2Max;
-	UINT32 Vendor00IncludeAbsSenseRawCapTest;
-	UINT32 Vendor00AbsSenseRawCapTxRxStart;
-	UINT32 Vendor00AbsSenseRawCapTxRxEnd;
-	UINT32 Vendor00AbsSenseRawCapMinLimit;
-	UINT32 Vendor00AbsSenseRawCapMaxLimit;
-	UINT32 Vendor00IncludeShortTest;
-	UINT32 Vendor01IncludeHighResTest;
-	UINT32 Vendor01HighResMaxRxLimit;
-	UINT32 Vendor01HighResMaxTxLimit;
-	UINT32 Vendor01HighResMinImageLimit;
-	UINT32 Vendor01IncludeBaselineMinMaxTest;
-	UINT32 Vendor01BaselineMinMaxMinPixelLimit;
-	UINT32 Vendor01BaselineMinMaxMaxPixelLimit;
-	UINT32 Vendor01IncludeFullBaselineTest;
-	UINT32 Vendor01RxAmount;
-	UINT32 Vendor01TxAmount;
-	UINT32 Vendor01RxElectrodeMaskTouch2D;
-	UINT32 Vendor01TxElectrodeMaskTouch2D;
-	UINT32 Vendor01RxElectrodeMaskButtons;
-	UINT32 Vendor01TxElectrodeMaskButtons;
-	UINT32 Vendor01FullBaselineButton0Min;
-	UINT32 Vendor01FullBaselineButton1Min;
-	UINT32 Vendor01FullBaselineButton2Min;
-	UINT32 Vendor01FullBaselineButton0Max;
-	UINT32 Vendor01FullBaselineButton1Max;
-	UINT32 Vendor01FullBaselineButton2Max;
-	UINT32 Vendor01IncludeAbsSenseRawCapTest;
-	UINT32 Vendor01AbsSenseRawCapTxRxStart;
-	UINT32 Vendor01AbsSenseRawCapTxRxEnd;
-	UINT32 Vendor01AbsSenseRawCapMinLimit;
-	UINT32 Vendor01AbsSenseRawCapMaxLimit;
-	UINT32 Vendor01IncludeShortTest;
-	UINT32 Vendor02IncludeHighResTest;
-	UINT32 Vendor02HighResMaxRxLimit;
-	UINT32 Vendor02HighResMaxTxLimit;
-	UINT32 Vendor02HighResMinImageLimit;
-	UINT32 Vendor02IncludeBaselineMinMaxTest;
-	UINT32 Vendor02BaselineMinMaxMinPixelLimit;
-	UINT32 Vendor02BaselineMinMaxMaxPixelLimit;
-	UINT32 Vendor02IncludeFullBaselineTest;
-	UINT32 Vendor02RxAmount;
-	UINT32 Vendor02TxAmount;
-	UINT32 Vendor02RxElectrodeMaskTouch2D;
-	UINT32 Vendor02TxElectrodeMaskTouch2D;
-	UINT32 Vendor02RxElectrodeMaskButtons;
-	UINT32 Vendor02TxElectrodeMaskButtons;
-	UINT32 Vendor02FullBaselineButton0Min;
-	UINT32 Vendor02FullBaselineButton1Min;
-	UINT32 Vendor02FullBaselineButton2Min;
-	UINT32 Vendor02FullBaselineButton0Max;
-	UINT32 Vendor02FullBaselineButton1Max;
-	UINT32 Vendor02FullBaselineButton2Max;
-	UINT32 Vendor02IncludeAbsSenseRawCapTest;
-	UINT32 Vendor02AbsSenseRawCapTxRxStart;
-	UINT32 Vendor02AbsSenseRawCapTxRxEnd;
-	UINT32 Vendor02AbsSenseRawCapMinLimit;
-	UINT32 Vendor02AbsSenseRawCapMaxLimit;
-	UINT32 Vendor02IncludeShortTest;
-	UINT32 Vendor03IncludeHighResTest;
-	UINT32 Vendor03HighResMaxRxLimit;
-	UINT32 Vendor03HighResMaxTxLimit;
-	UINT32 Vendor03HighResMinImageLimit;
-	UINT32 Vendor03IncludeBaselineMinMaxTest;
-	UINT32 Vendor03BaselineMinMaxMinPixelLimit;
-	UINT32 Vendor03BaselineMinMaxMaxPixelLimit;
-	UINT32 Vendor03IncludeFullBaselineTest;
-	UINT32 Vendor03RxAmount;
-	UINT32 Vendor03TxAmount;
-	UINT32 Vendor03RxElectrodeMaskTouch2D;
-	UINT32 Vendor03TxElectrodeMaskTouch2D;
-	UINT32 Vendor03RxElectrodeMaskButtons;
-	UINT32 Vendor03TxElectrodeMaskButtons;
-	UINT32 Vendor03FullBaselineButton0Min;
-	UINT32 Vendor03FullBaselineButton1Min;
-	UINT32 Vendor03FullBaselineButton2Min;
-	UINT32 Vendor03FullBaselineButton0Max;
-	UINT32 Vendor03FullBaselineButton1Max;
-	UINT32 Vendor03FullBaselineButton2Max;
-	UINT32 Vendor03IncludeAbsSenseRawCapTest;
-	UINT32 Vendor03AbsSenseRawCapTxRxStart;
-	UINT32 Vendor03AbsSenseRawCapTxRxEnd;
-	UINT32 Vendor03AbsSenseRawCapMinLimit;
-	UINT32 Vendor03AbsSenseRawCapMaxLimit;
-	UINT32 Vendor03IncludeShortTest;
+	TOUCH_SETTINGS_GLOBAL(TOUCH_SETTINGS_FIELD)
+	TOUCH_SETTINGS_PER_VENDOR(TOUCH_SETTINGS_VENDOR_FIELD)
+	TOUCH_VENDOR_SETTINGS VendorSettings[TOUCH_SETTINGS_VENDOR_COUNT];
 } TOUCH_SCREEN_SETTINGS, * PTOUCH_SCREEN_SETTINGS;
 
+#undef TOUCH_SETTINGS_FIELD
+#undef TOUCH_SETTINGS_VENDOR_FIELD
+
 NTSTATUS 
 TchAllocateContext(
     OUT VOID **ControllerContext,
@@ -217,6 +156,12 @@ TchFreeContext(
     IN VOID *ControllerContext
     );
 
+NTSTATUS
+TchWaitForControllerReady(
+	IN SPB_CONTEXT* SpbContext,
+	IN ULONG Timeout
+);
+
 NTSTATUS
 TchStartDevice(
 	IN VOID* ControllerContext,
@@ -34,4 +34,12 @@ NTSTATUS
 TchClearObjectInterrupts(
 	IN FTS_CONTROLLER_CONTEXT* ControllerContext,
 	IN SPB_CONTEXT* SpbContext
-);
\ No newline at end of file
+);
+
+NTSTATUS
+TchReplayObjectEvents(
+	IN FTS_CONTROLLER_CONTEXT* ControllerContext,
+	IN PREPORT_CONTEXT ReportContext,
+	IN BYTE* EventData,
+	IN DWORD EventDataLength
+);
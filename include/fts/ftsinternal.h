@@ -28,6 +28,7 @@
 #include <Cross Platform Shim/bitops.h>
 #include <Cross Platform Shim/hweight.h>
 #include <report.h>
+#include <fts\ftsregs.h>
 
 // Ignore warning C4152: nonstandard extension, function/data pointer conversion in expression
 #pragma warning (disable : 4152)
@@ -118,6 +119,29 @@ typedef struct _FTS_CONFIGURATION
 	UINT32 PepRemovesVoltageInD3;
 } FTS_CONFIGURATION;
 
+typedef enum _FTS_CHIP_FAMILY
+{
+	FTS_CHIP_FAMILY_UNKNOWN = 0,
+	FTS_CHIP_FAMILY_FTM3 = 1,
+	FTS_CHIP_FAMILY_FTM4 = 2,
+} FTS_CHIP_FAMILY;
+
+//
+// Pointer events of a FIFO batch, decoded into one array per field. Bits
+// of OtherEvents flag the events of the batch that are not pointer events.
+//
+typedef struct _FTS_POINTER_BATCH
+{
+	DWORD Count;
+	BYTE TouchId[FIFO_DEPTH];
+	BYTE State[FIFO_DEPTH];
+	USHORT X[FIFO_DEPTH];
+	USHORT Y[FIFO_DEPTH];
+	UCHAR Pressure[FIFO_DEPTH];
+	UCHAR Size[FIFO_DEPTH];
+	unsigned long OtherEvents[BITS_TO_LONGS(FIFO_DEPTH)];
+} FTS_POINTER_BATCH;
+
 typedef struct _FTS_CONTROLLER_CONTEXT
 {
 	WDFDEVICE FxDevice;
@@ -136,9 +160,75 @@ typedef struct _FTS_CONTROLLER_CONTEXT
 
 	BYTE MaxFingers;
 
+	//
+	// Chip family detected at start, selects the IER register. When the
+	// family is unknown both registers are re-armed after every interrupt
+	// as a precaution, otherwise only when InterruptEnablePending is set
+	//
+	FTS_CHIP_FAMILY ChipFamily;
+	BOOLEAN InterruptEnablePending;
+
+	//
+	// Number of FIFO events read in the first transaction of an
+	// interrupt, see FTS_DEFAULT_FIFO_SPECULATIVE_EVENTS
+	//
+	DWORD FifoSpeculativeEvents;
+
+	//
+	// Device lifetime storage for events read out of the FIFO so the
+	// interrupt path does not allocate from pool
+	//
+	BYTE EventBuffer[FIFO_DEPTH * FIFO_EVENT_SIZE];
+
+	//
+	// Length of the events still being read into EventBuffer
+	//
+	DWORD EventTailLength;
+
+	//
+	// Set when FIFO events were lost, either because the FIFO overflowed,
+	// the controller reported an error or reading the FIFO failed. The
+	// FIFO is then flushed and all contacts are lifted so no ghost
+	// contact stays down.
+	//
+	BOOLEAN ResyncPending;
+	ULONG FifoOverflows;
+	ULONG FifoResyncs;
+
+	//
+	// Pointer events of the FIFO batch being processed
+	//
+	FTS_POINTER_BATCH PointerBatch;
+
 	DETECTED_OBJECTS DetectedObjects;
+
+	//
+	// Report coalescing, when enabled all events of a FIFO batch are
+	// applied to DetectedObjects before a single frame is reported
+	//
+	BOOLEAN CoalesceReports;
+	BOOLEAN ReportPending;
+	ULONG PendingPresenceMask;
 } FTS_CONTROLLER_CONTEXT;
 
+//
+// Most interrupts carry only a handful of events, reading this many in
+// the first transaction avoids a second bus round trip for them
+//
+#define FTS_DEFAULT_FIFO_SPECULATIVE_EVENTS 4
+
+//
+// Report once per interrupt rather than once per FIFO event
+//
+#define FTS_DEFAULT_COALESCE_REPORTS TRUE
+
+//
+// Poll interval bounds while waiting for the controller ready event
+// after a reset, in microseconds
+//
+#define FTS_READY_POLL_MIN_INTERVAL 1000
+#define FTS_READY_POLL_MAX_INTERVAL 32000
+
 #define DEVICE_CONTROL_SLEEP_MODE_OPERATING  0
 #define DEVICE_CONTROL_SLEEP_MODE_SLEEPING   1
 
@@ -165,6 +255,12 @@ FtsChangePage(
 	IN int DesiredPage
 );
 
+NTSTATUS
+FtsDetectChipFamily(
+	IN FTS_CONTROLLER_CONTEXT* ControllerContext,
+	IN SPB_CONTEXT* SpbContext
+);
+
 NTSTATUS
 FtsConfigureFunctions(
 	IN FTS_CONTROLLER_CONTEXT* ControllerContext,
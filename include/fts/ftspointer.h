@@ -23,24 +23,30 @@
 
 #include <fts\ftsinternal.h>
 
-
 NTSTATUS
-FtsProcessEnterPointerEvent(
+FtsFlushPointerReport(
 	FTS_CONTROLLER_CONTEXT* ControllerContext,
-	PREPORT_CONTEXT ReportContext,
-	BYTE* EventData
+	PREPORT_CONTEXT ReportContext
+);
+
+VOID
+FtsDecodePointerEvents(
+	BYTE* EventData,
+	DWORD EventCount,
+	FTS_POINTER_BATCH* Batch
 );
 
 NTSTATUS
-FtsProcessMotionPointerEvent(
+FtsApplyPointerEvents(
 	FTS_CONTROLLER_CONTEXT* ControllerContext,
 	PREPORT_CONTEXT ReportContext,
-	BYTE* EventData
+	FTS_POINTER_BATCH* Batch,
+	DWORD First,
+	DWORD Last
 );
 
 NTSTATUS
-FtsProcessLeavePointerEvent(
+FtsLiftAllPointers(
 	FTS_CONTROLLER_CONTEXT* ControllerContext,
-	PREPORT_CONTEXT ReportContext,
-	BYTE* EventData
-);
\ No newline at end of file
+	PREPORT_CONTEXT ReportContext
+);
@@ -34,6 +34,21 @@
 
 #define IER_ENABLE			0x41
 
+//
+// Chip identification, the first byte returned by a hardware register
+// read is a dummy byte and is followed by the two ID bytes
+//
+#define CHIP_ID_ADDR_FTM3		0x00, 0x07
+#define CHIP_ID_ADDR_FTM4		0x00, 0x04
+
+#define CHIP_ID_FTM3_0			0x39
+#define CHIP_ID_FTM3_1			0x6C
+
+#define CHIP_ID_FTM4_0			0x36
+#define CHIP_ID_FTM4_1			0x70
+
+#define CHIP_ID_READ_SIZE		3
+
 /*#ifdef FTM3_CHIP
 #define FIFO_DEPTH			32
 #else*/
@@ -42,13 +57,52 @@
 
 #define FIFO_CMD_READONE	0x85
 #define FIFO_CMD_READALL	0x86
+#define FIFO_CMD_FLUSH		0xA1
 
 #define FIFO_EVENT_SIZE		8
 
 #define FTS_CMD_MS_MT_SENSE_ON	0x93
 
 #define FTS_CMD_HW_REG_W	0xB6
+#define FTS_CMD_HW_REG_R	0xB6
 
+#define EVENTID_NO_EVENT	     0x00
 #define EVENTID_ENTER_POINTER	     0x03
 #define EVENTID_LEAVE_POINTER	     0x04
-#define EVENTID_MOTION_POINTER	     0x05
\ No newline at end of file
+#define EVENTID_MOTION_POINTER	     0x05
+#define EVENTID_HOVER_ENTER_POINTER	     0x07
+#define EVENTID_HOVER_LEAVE_POINTER	     0x08
+#define EVENTID_HOVER_MOTION_POINTER	     0x09
+#define EVENTID_BUTTON_STATUS	     0x0E
+#define EVENTID_ERROR	     0x0F
+#define EVENTID_CONTROLLER_READY	     0x10
+#define EVENTID_SLEEPOUT_CONTROLLER_READY	     0x11
+#define EVENTID_STATUS	     0x16
+#define EVENTID_GESTURE	     0x20
+#define EVENTID_PEN_ENTER	     0x23
+#define EVENTID_PEN_LEAVE	     0x24
+#define EVENTID_PEN_MOTION	     0x25
+#define EVENTID_LAST	     0x100
+
+//
+// Pointer event layout
+//
+#define EVENT_TOUCH_ID(e)	((e)[2] & 0x0F)
+#define EVENT_X(e)	(((e)[3] << 4) | (((e)[5] & 0xF0) >> 4))
+#define EVENT_Y(e)	(((e)[4] << 4) | ((e)[5] & 0x0F))
+#define EVENT_PRESSURE(e)	((e)[6] & 0x3F)
+#define EVENT_SIZE(e)	(((e)[7] & 0xE0) >> 5)
+
+//
+// Number of events left in the FIFO after an event, the count saturates
+// when more events are pending than it can hold
+//
+#define EVENT_LEFT_EVENTS(e)	((e)[7] & 0x1F)
+#define EVENT_LEFT_EVENTS_SATURATED	0x1F
+
+//
+// Button status event layout
+//
+#define EVENT_BUTTON_BACK(e)	(((e)[3] & 0x01) != 0)
+#define EVENT_BUTTON_START(e)	(((e)[3] & 0x02) != 0)
+#define EVENT_BUTTON_SEARCH(e)	(((e)[3] & 0x04) != 0)
\ No newline at end of file
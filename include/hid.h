@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include "HidCommon.h"
+
 //
 // Global Data Declarations
 //
@@ -58,11 +60,19 @@ typedef struct _HID_TOUCH_FINGER {
 } HID_TOUCH_FINGER, * PHID_TOUCH_FINGER;
 #pragma pack(pop)
 
+//
+// The contact count follows the last contact of the report, use
+// HID_TOUCH_REPORT_CONTACT_COUNT rather than ContactCount unless the
+// report carries TOUCH_MAX_CONTACTS_PER_REPORT contacts
+//
 typedef struct _HID_TOUCH_REPORT {
-	HID_TOUCH_FINGER Contacts[2];
+	HID_TOUCH_FINGER Contacts[TOUCH_MAX_CONTACTS_PER_REPORT];
 	UCHAR            ContactCount;
 } HID_TOUCH_REPORT, * PHID_TOUCH_REPORT;
 
+#define HID_TOUCH_REPORT_CONTACT_COUNT(TouchReport, ContactsPerReport) \
+	(*(PUCHAR)&(TouchReport)->Contacts[(ContactsPerReport)])
+
 // REPORTID_KEYPAD
 typedef struct _HID_KEY_REPORT {
 	UCHAR  SystemPowerDown : 1;
@@ -114,10 +124,17 @@ typedef struct _HID_INPUT_REPORT
 // Function prototypes
 //
 
+VOID
+TchTraceReport(
+	IN PHID_INPUT_REPORT hidReportFromDriver,
+	IN ULONG ContactsPerReport
+);
+
 NTSTATUS
-TchSendReport(
-	IN WDFQUEUE PingPongQueue,
-	IN PHID_INPUT_REPORT hidReportFromDriver
+TchCompleteReadRequest(
+	IN WDFREQUEST request,
+	IN PHID_INPUT_REPORT hidReportFromDriver,
+	IN ULONG ContactsPerReport
 );
 
 NTSTATUS
@@ -172,7 +189,6 @@ TchReadReport(
 //
 // HID collections
 // 
-#include "HidCommon.h"
 
 #define X_MASK 0xFE, 0xFE
 #define Y_MASK 0xFD, 0xFD
@@ -255,6 +271,28 @@ TchReadReport(
 		UNIT, 0x00, /* Unit: None */ \
 	END_COLLECTION /* End Collection */
 
+#define ST_FTS_DIGITIZER_FINGER_CONTACT_N \
+	USAGE, 0x00, /* Usage (Undefined) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_2
+
+#define ST_FTS_DIGITIZER_FINGER_CONTACTS_2 \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_1, /* Finger Contact (1) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_N /* Finger Contact (2) */
+
+#define ST_FTS_DIGITIZER_FINGER_CONTACTS_5 \
+	ST_FTS_DIGITIZER_FINGER_CONTACTS_2, /* Finger Contacts (1-2) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_N, /* Finger Contact (3) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_N, /* Finger Contact (4) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_N /* Finger Contact (5) */
+
+#define ST_FTS_DIGITIZER_FINGER_CONTACTS_10 \
+	ST_FTS_DIGITIZER_FINGER_CONTACTS_5, /* Finger Contacts (1-5) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_N, /* Finger Contact (6) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_N, /* Finger Contact (7) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_N, /* Finger Contact (8) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_N, /* Finger Contact (9) */ \
+	ST_FTS_DIGITIZER_FINGER_CONTACT_N /* Finger Contact (10) */
+
 #define ST_FTS_DIGITIZER_STYLUS_CONTACT_1 \
 	BEGIN_COLLECTION, 0x00, /* Collection (Physical) */ \
 		USAGE, 0x42, /* Usage (Tip Switch) */ \
@@ -378,15 +416,17 @@ TchReadReport(
 		FEATURE, 0x02, /* Feature: (Data, Var, Abs) */ \
 	END_COLLECTION /* End Collection */
 
-#define ST_FTS_DIGITIZER_FINGER \
+//
+// Variadic so that a contacts list expanded by an enclosing macro is still
+// passed as one argument by conforming preprocessors
+//
+#define ST_FTS_DIGITIZER_FINGER(...) \
 	USAGE_PAGE, 0x0D, /* Usage Page (Digitizer) */ \
 	USAGE, 0x04, /* Usage (Touch Screen) */ \
 	BEGIN_COLLECTION, 0x01, /* Collection (Application) */ \
 		REPORT_ID, REPORTID_FINGER, /* Report ID (1) */ \
 		USAGE, 0x22, /* Usage (Finger) */ \
-		ST_FTS_DIGITIZER_FINGER_CONTACT_1, /* Finger Contact (1) */ \
-		USAGE, 0x00, /* Usage (Undefined) */ \
-		ST_FTS_DIGITIZER_FINGER_CONTACT_2, /* Finger Contact (2) */ \
+		__VA_ARGS__, /* Finger Contacts */ \
 		USAGE_PAGE, 0x0D, /* Usage Page (Digitizer) */ \
 		USAGE, 0x54, /* Usage (Contact Count) */ \
 		REPORT_SIZE, 0x08, /* Report Size (8) */ \
@@ -502,6 +542,20 @@ TchReadReport(
 		FEATURE, 0x02, \
 	END_COLLECTION /* End Collection */
 
+//
+// Report descriptor of the device, FINGER_CONTACTS is one of the
+// ST_FTS_DIGITIZER_FINGER_CONTACTS_* lists
+//
+#define ST_FTS_REPORT_DESCRIPTOR(FINGER_CONTACTS) \
+	ST_FTS_DIGITIZER_DIAGNOSTIC1, \
+	ST_FTS_DIGITIZER_DIAGNOSTIC2, \
+	ST_FTS_DIGITIZER_DIAGNOSTIC3, \
+	ST_FTS_DIGITIZER_DIAGNOSTIC4, \
+	ST_FTS_DIGITIZER_FINGER(FINGER_CONTACTS), \
+	ST_FTS_DIGITIZER_REPORTMODE, \
+	ST_FTS_DIGITIZER_KEYPAD, \
+	ST_FTS_DIGITIZER_STYLUS
+
 #define DEFAULT_PTP_HQA_BLOB \
 	0xfc, 0x28, 0xfe, 0x84, 0x40, 0xcb, 0x9a, 0x87, \
 	0x0d, 0xbe, 0x57, 0x3c, 0xb6, 0x70, 0x09, 0x88, \
@@ -122,6 +122,32 @@ typedef struct _DEVICE_EXTENSION
     // Touch Power
     //
     TOUCH_POWER_CONTEXT TouchPowerContext;
+
+    //
+    // WakeupGesture setting cached for the display off path, refreshed
+    // from a work item whenever its registry key changes. The key is only
+    // closed and the notification only re-armed under WakeupGestureLock.
+    //
+    volatile LONG WakeupGestureEnabled;
+    HANDLE WakeupGestureKey;
+    WORK_QUEUE_ITEM WakeupGestureNotifyItem;
+    WDFWORKITEM WakeupGestureWorkItem;
+    WDFWAITLOCK WakeupGestureLock;
+    IO_STATUS_BLOCK WakeupGestureIoStatus;
+    KEVENT WakeupGestureNotifyIdle;
+    volatile BOOLEAN WakeupGestureStopping;
 } DEVICE_EXTENSION, *PDEVICE_EXTENSION;
 
 WDF_DECLARE_CONTEXT_TYPE_WITH_NAME(DEVICE_EXTENSION, GetDeviceContext)
+
+NTSTATUS
+TchWakeupGestureCacheInitialize(
+    IN PDEVICE_EXTENSION DeviceContext
+    );
+
+VOID
+TchWakeupGestureCacheDeinitialize(
+    IN PDEVICE_EXTENSION DeviceContext
+    );
+
+EVT_WDF_WORKITEM TchWakeupGestureWorkItem;
@@ -0,0 +1,91 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		latency.h
+
+	Abstract:
+
+		Interrupt to report latency histograms
+
+	Environment:
+
+		Kernel mode
+
+	Revision History:
+
+--*/
+
+#pragma once
+
+#include <Cross Platform Shim\compat.h>
+#include <wdm.h>
+
+//
+// Stages of the report pipeline, every stage is measured from the entry
+// of the interrupt service routine that started the frame
+//
+typedef enum _LATENCY_STAGE
+{
+	LATENCY_STAGE_FIFO_READ = 0,
+	LATENCY_STAGE_DECODE = 1,
+	LATENCY_STAGE_REPORT_QUEUED = 2,
+	LATENCY_STAGE_REPORT_COMPLETED = 3,
+	LATENCY_STAGE_COUNT
+} LATENCY_STAGE;
+
+//
+// Bucket i counts samples of [2^(i-1), 2^i) microseconds, bucket 0 counts
+// samples below one microsecond and the last bucket everything above
+//
+#define LATENCY_HISTOGRAM_BUCKETS  32
+
+typedef struct _LATENCY_CONTEXT
+{
+	volatile LONG Buckets[LATENCY_STAGE_COUNT][LATENCY_HISTOGRAM_BUCKETS];
+
+	//
+	// Interrupt time of the ISR entry of the frame being serviced and the
+	// thread servicing it. The frame start is only handed out to that
+	// thread, reports sent from other paths, such as the re-report timer
+	// or a replay, are not measured even while a frame is in progress.
+	//
+	volatile LONG64 FrameStart;
+	PKTHREAD FrameThread;
+} LATENCY_CONTEXT;
+
+VOID
+LatencyStartFrame(
+	IN LATENCY_CONTEXT* Latency
+);
+
+VOID
+LatencyEndFrame(
+	IN LATENCY_CONTEXT* Latency
+);
+
+ULONG64
+LatencyFrameStart(
+	IN LATENCY_CONTEXT* Latency
+);
+
+VOID
+LatencyRecord(
+	IN LATENCY_CONTEXT* Latency,
+	IN LATENCY_STAGE Stage
+);
+
+VOID
+LatencyRecordSince(
+	IN LATENCY_CONTEXT* Latency,
+	IN LATENCY_STAGE Stage,
+	IN ULONG64 Start
+);
+
+VOID
+LatencyReadHistogram(
+	IN LATENCY_CONTEXT* Latency,
+	OUT ULONG* Counts,
+	IN BOOLEAN Reset
+);
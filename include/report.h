@@ -26,7 +26,8 @@
 #include <resolutions.h>
 #include <hid.h>
 #include <HidCommon.h>
-#include <spb.h>
+#include <spbhelper.h>
+#include <latency.h>
 
 #define MAX_TOUCHES                32
 #define MAX_BUTTONS                3
@@ -36,14 +37,25 @@ typedef struct _OBJECT_INFO
 	int x;
 	int y;
 	UCHAR status;
+	UCHAR pressure;
+	UCHAR size;
 } OBJECT_INFO;
 
+//
+// Slots that are down are kept in an intrusive list in the order they
+// went down, DownHead and DownTail are only meaningful if DownCount > 0.
+// PenSlots flags the slots holding a pen, up to the report of its lift.
+//
 typedef struct _OBJECT_CACHE
 {
 	OBJECT_INFO Slot[MAX_TOUCHES];
 	UINT32 SlotValid;
 	UINT32 SlotDirty;
-	int DownOrder[MAX_TOUCHES];
+	UINT32 PenSlots;
+	int DownNext[MAX_TOUCHES];
+	int DownPrev[MAX_TOUCHES];
+	int DownHead;
+	int DownTail;
 	int DownCount;
 	ULONG64 ScanTime;
 } OBJECT_CACHE;
@@ -68,6 +80,24 @@ typedef struct _DETECTED_OBJECTS
 {
 	OBJECT_STATE States[MAX_TOUCHES];
 	DETECTED_OBJECT_POSITION Positions[MAX_TOUCHES];
+
+	//
+	// Pressure and contact size as reported by the controller, in
+	// controller units
+	//
+	UCHAR Pressure[MAX_TOUCHES];
+	UCHAR Size[MAX_TOUCHES];
+
+	//
+	// Bit i is set when States[i] is not OBJECT_STATE_NOT_PRESENT
+	//
+	UINT32 PresentMask;
+
+	//
+	// Bit i is set when slot i changed since the last report, the report
+	// layer only reads those slots and clears the mask
+	//
+	UINT32 DirtyMask;
 } DETECTED_OBJECTS;
 
 typedef struct _BUTTON_CACHE
@@ -75,15 +105,84 @@ typedef struct _BUTTON_CACHE
 	BOOLEAN ButtonSlots[MAX_BUTTONS];
 } BUTTON_CACHE;
 
+//
+// Reports waiting for a HIDClass read request. The size must be a power
+// of two, the last REPORT_RING_RESERVE entries are kept for reports that
+// must not be dropped such as lift-offs. Producers are serialized by
+// PushLock, the consumer only ever advances Tail.
+//
+#define REPORT_RING_SIZE           32
+#define REPORT_RING_RESERVE        8
+
+typedef enum _REPORT_RING_OVERFLOW_POLICY
+{
+	REPORT_RING_DROP_OLDEST_MOTION = 0,
+	REPORT_RING_DROP_NEWEST = 1,
+} REPORT_RING_OVERFLOW_POLICY;
+
+C_ASSERT(TOUCH_DEFAULT_REPORT_OVERFLOW_POLICY == REPORT_RING_DROP_OLDEST_MOTION);
+C_ASSERT(TOUCH_MAX_REPORT_OVERFLOW_POLICY == REPORT_RING_DROP_NEWEST);
+
+typedef struct _REPORT_RING_ENTRY
+{
+	HID_INPUT_REPORT Report;
+	ULONG64 Timestamp;
+	ULONG64 FrameStart;
+	BOOLEAN Droppable;
+} REPORT_RING_ENTRY;
+
+typedef struct _REPORT_RING
+{
+	REPORT_RING_ENTRY Entries[REPORT_RING_SIZE];
+	volatile LONG Head;
+	volatile LONG Tail;
+	volatile LONG DrainRequests;
+	WDFSPINLOCK PushLock;
+	REPORT_RING_OVERFLOW_POLICY OverflowPolicy;
+	ULONG DroppedReports;
+	ULONG LostLiftOffs;
+} REPORT_RING;
+
 typedef struct _REPORT_CONTEXT
 {
 	BUTTON_CACHE ButtonCache;
 	BOOLEAN PenPresent;
 	OBJECT_CACHE Cache;
 	TOUCH_SCREEN_PROPERTIES Props;
+	TOUCH_TRANSLATION Translation;
 	WDFQUEUE PingPongQueue;
+	REPORT_RING Ring;
+
+	//
+	// Re-reporting of held contacts for hardware that lacks continuous
+	// reporting, the lock serializes the timer with the event path.
+	// Times are in 100ns units.
+	//
+	WDFTIMER ReReportTimer;
+	WDFSPINLOCK ReReportLock;
+	ULONG64 ReReportInterval;
+	ULONG64 LastReportTime;
+	BOOLEAN ReReportArmed;
+
+	//
+	// Interrupt to report latency, read through the self-test interface
+	//
+	LATENCY_CONTEXT Latency;
 } REPORT_CONTEXT, * PREPORT_CONTEXT;
 
+NTSTATUS
+ReportSendHidReport(
+	IN PREPORT_CONTEXT ReportContext,
+	IN PHID_INPUT_REPORT HidReport,
+	IN BOOLEAN Droppable,
+	IN ULONG64 FrameStart
+);
+
+VOID
+ReportDrainRing(
+	IN PREPORT_CONTEXT ReportContext
+);
+
 NTSTATUS
 ReportWakeup(
 	IN PREPORT_CONTEXT ReportContext
@@ -109,16 +208,18 @@ ReportPen(
 	IN USHORT Y,
 	IN USHORT TipPressure,
 	IN USHORT XTilt,
-	IN USHORT YTilt
+	IN USHORT YTilt,
+	IN ULONG64 FrameStart
 );
 
 NTSTATUS
 ReportObjects(
 	IN PREPORT_CONTEXT ReportContext,
-	IN DETECTED_OBJECTS data
+	IN OUT DETECTED_OBJECTS* Data
 );
 
 NTSTATUS
 ReportConfigureContinuousSimulationTimer(
-	IN WDFDEVICE DeviceHandle
+	IN WDFDEVICE DeviceHandle,
+	IN PREPORT_CONTEXT ReportContext
 );
\ No newline at end of file
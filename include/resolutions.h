@@ -26,6 +26,21 @@
 #define TOUCH_DEVICE_RESOLUTION_X   1440
 #define TOUCH_DEVICE_RESOLUTION_Y   2560
 
+//
+// Rate in Hz at which held contacts are re-reported on hardware that
+// lacks continuous reporting
+//
+#define TOUCH_DEFAULT_CONTINUOUS_REPORT_RATE 120
+#define TOUCH_MAX_CONTINUOUS_REPORT_RATE     1000
+#define TOUCH_RATE_TO_INTERVAL(rate)         (10000000ULL / (rate))
+
+//
+// Report ring overflow policy, one of REPORT_RING_OVERFLOW_POLICY:
+// 0 drops the oldest buffered motion report, 1 drops the newest report
+//
+#define TOUCH_DEFAULT_REPORT_OVERFLOW_POLICY 0
+#define TOUCH_MAX_REPORT_OVERFLOW_POLICY     1
+
 typedef struct _TOUCH_SCREEN_PROPERTIES
 {
     UINT32 TouchSwapAxes;
@@ -49,13 +64,52 @@ typedef struct _TOUCH_SCREEN_PROPERTIES
     UINT32 DisplayHeight10um;
     UINT32 DisplayWidth10um;
     UINT32 TouchHardwareLacksContinuousReporting;
+    UINT32 ContactsPerReport;
+    UINT32 ContinuousReportRate;
+    UINT32 ReportOverflowPolicy;
 } TOUCH_SCREEN_PROPERTIES, * PTOUCH_SCREEN_PROPERTIES;
 
+//
+// Controller coordinates are 12-bit, every axis of the translation is
+// precomputed for that range when the screen properties are loaded
+//
+#define TOUCH_TRANSLATION_TABLE_SIZE 4096
+
+typedef struct _TOUCH_TRANSLATION
+{
+    ULONG SwapAxes;
+    USHORT X[TOUCH_TRANSLATION_TABLE_SIZE];
+    USHORT Y[TOUCH_TRANSLATION_TABLE_SIZE];
+} TOUCH_TRANSLATION, * PTOUCH_TRANSLATION;
+
 VOID
 TchGetScreenProperties(
 	IN PTOUCH_SCREEN_PROPERTIES Props
 );
 
+VOID
+TchBuildTranslation(
+	OUT PTOUCH_TRANSLATION Translation,
+	IN PTOUCH_SCREEN_PROPERTIES Props
+);
+
+VOID
+TchTranslateWithTable(
+	IN PUSHORT X,
+	IN PUSHORT Y,
+	IN PTOUCH_TRANSLATION Translation,
+	IN PTOUCH_SCREEN_PROPERTIES Props
+);
+
+VOID
+TchTranslateBatchWithTable(
+	IN OUT PUSHORT X,
+	IN OUT PUSHORT Y,
+	IN ULONG Count,
+	IN PTOUCH_TRANSLATION Translation,
+	IN PTOUCH_SCREEN_PROPERTIES Props
+);
+
 VOID
 TchTranslateToDisplayCoordinates(
 	IN PUSHORT X,
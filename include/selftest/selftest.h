@@ -37,6 +37,30 @@ DEFINE_GUID(GUID_TOUCH_SELFTEST_INTERFACE,
 #define IOCTL_TOUCH_SELFTEST_WRITE          TOUCH_TEST_BUFFER_CTL_CODE(101)
 #define IOCTL_TOUCH_SELFTEST_MODE           TOUCH_TEST_BUFFER_CTL_CODE(102)
 #define IOCTL_TOUCH_SELFTEST_CHANGE_PAGE    TOUCH_TEST_BUFFER_CTL_CODE(103)
+#define IOCTL_TOUCH_SELFTEST_REPLAY         TOUCH_TEST_BUFFER_CTL_CODE(104)
+#define IOCTL_TOUCH_SELFTEST_LATENCY        TOUCH_TEST_BUFFER_CTL_CODE(105)
+
+//
+// IOCTL_TOUCH_SELFTEST_REPLAY takes up to TOUCH_TEST_REPLAY_MAX_EVENTS
+// recorded 8 byte FIFO events and runs them through the report pipeline
+//
+#define TOUCH_TEST_REPLAY_MAX_EVENTS        64
+
+//
+// IOCTL_TOUCH_SELFTEST_LATENCY returns the interrupt to report latency
+// histograms, an optional BOOLEAN input set to TRUE clears them. Stages
+// are FIFO read, decode, report queued and report completed, all
+// measured from the ISR entry. Bucket i counts samples of
+// [2^(i-1), 2^i) microseconds, bucket 0 samples below one microsecond.
+// Replayed events and re-reported frames are not measured.
+//
+#define TOUCH_TEST_LATENCY_STAGES           4
+#define TOUCH_TEST_LATENCY_BUCKETS          32
+
+typedef struct _TOUCH_TEST_LATENCY_HISTOGRAM
+{
+    ULONG Count[TOUCH_TEST_LATENCY_STAGES][TOUCH_TEST_LATENCY_BUCKETS];
+} TOUCH_TEST_LATENCY_HISTOGRAM;
 
 typedef struct _TOUCH_TEST_I2C_HEADER
 {
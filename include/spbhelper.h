@@ -0,0 +1,132 @@
+/*++
+    Copyright (c) Microsoft Corporation. All Rights Reserved. 
+    Sample code. Dealpoint ID #843729.
+
+    Module Name: 
+
+        spbhelper.h
+
+    Abstract:
+
+        This module contains the touch driver I2C helper definitions.
+
+    Environment:
+ 
+        Kernel Mode
+
+    Revision History:
+
+--*/
+
+#pragma once
+
+#include <wdm.h>
+#include <wdf.h>
+
+//
+// SPB_FIFO_BUFFER_SIZE holds a full FIFO read (FIFO_DEPTH events of
+// FIFO_EVENT_SIZE bytes) plus the command byte, ftsevents.c checks it
+// against the FTS constants
+//
+#define DEFAULT_SPB_BUFFER_SIZE 64
+#define SPB_FIFO_BUFFER_SIZE    (512 + 1)
+#define SPB_LARGE_BUFFER_SIZE   4096
+#define SPB_BUFFER_CLASS_COUNT  3
+
+//
+// SPB (I2C) context
+//
+
+typedef struct _SPB_CONTEXT SPB_CONTEXT;
+
+typedef
+VOID
+(*PFN_SPB_ASYNC_COMPLETION)(
+    _In_ SPB_CONTEXT *SpbContext,
+    _In_ NTSTATUS Status,
+    _In_opt_ PVOID CompletionContext
+    );
+
+struct _SPB_CONTEXT
+{
+    WDFIOTARGET SpbIoTarget;
+    LARGE_INTEGER I2cResHubId;
+
+    //
+    // Preallocated transfer buffers, one per size class, shared by reads
+    // and writes as all transfers are serialized by the SpbLock
+    //
+    WDFMEMORY BufferPool[SPB_BUFFER_CLASS_COUNT];
+    ULONG BufferPoolHits[SPB_BUFFER_CLASS_COUNT];
+    ULONG BufferPoolMisses;
+
+    WDFWAITLOCK SpbLock;
+    BOOLEAN SequenceUnsupported;
+
+    //
+    // Asynchronous read state, the request and its sequence buffer are
+    // allocated once and reused for every read
+    //
+    WDFREQUEST AsyncRequest;
+    WDFMEMORY AsyncMemory;
+    KEVENT AsyncCompleted;
+    NTSTATUS AsyncStatus;
+    UCHAR AsyncAddress;
+    PVOID AsyncData;
+    ULONG AsyncLength;
+    PFN_SPB_ASYNC_COMPLETION AsyncCompletion;
+    PVOID AsyncCompletionContext;
+};
+
+NTSTATUS 
+SpbReadDataSynchronously(
+    _In_ SPB_CONTEXT *SpbContext,
+    _In_ UCHAR Address,
+    _In_reads_bytes_(Length) PVOID Data,
+    _In_ ULONG Length
+    );
+
+NTSTATUS
+SpbReadDataAsynchronously(
+    _In_ SPB_CONTEXT *SpbContext,
+    _In_ UCHAR Address,
+    _In_reads_bytes_(Length) PVOID Data,
+    _In_ ULONG Length,
+    _In_opt_ PFN_SPB_ASYNC_COMPLETION Completion,
+    _In_opt_ PVOID CompletionContext
+    );
+
+NTSTATUS
+SpbWaitForAsynchronousRead(
+    _In_ SPB_CONTEXT *SpbContext
+    );
+
+NTSTATUS
+SpbReadRegisterSynchronously(
+    _In_ SPB_CONTEXT *SpbContext,
+    _In_ UCHAR Command,
+    _In_ PVOID Register,
+    _In_ ULONG RegisterLength,
+    _In_reads_bytes_(Length) PVOID Data,
+    _In_ ULONG Length
+    );
+
+VOID
+SpbTargetDeinitialize(
+    IN WDFDEVICE FxDevice,
+    IN SPB_CONTEXT *SpbContext
+    );
+
+NTSTATUS
+SpbTargetInitialize(
+    IN WDFDEVICE FxDevice,
+    IN SPB_CONTEXT *SpbContext
+    );
+
+NTSTATUS
+SpbWriteDataSynchronously(
+    IN SPB_CONTEXT *SpbContext,
+    IN UCHAR Address,
+    IN PVOID Data,
+    IN ULONG Length
+    );
@@ -48,14 +48,79 @@
 #define WPP_RECORDER_FLAGS_LEVEL_ARGS(flags, lvl) WPP_RECORDER_LEVEL_FLAGS_ARGS(lvl, flags)
 #define WPP_RECORDER_FLAGS_LEVEL_FILTER(flags, lvl) WPP_RECORDER_LEVEL_FLAGS_FILTER(lvl, flags)
 
+//
+// Hot path tracing tiers. TraceHot is used on the interrupt and report
+// path and is compiled out unless the tier is FULL, TraceHotRing records
+// fixed size events into an in-memory ring for every tier but OFF.
+//
+#define TRACE_HOT_PATH_OFF                  0
+#define TRACE_HOT_PATH_RING                 1
+#define TRACE_HOT_PATH_FULL                 2
+
+#ifndef TRACE_HOT_PATH_LEVEL
+#if DBG
+#define TRACE_HOT_PATH_LEVEL                TRACE_HOT_PATH_FULL
+#else
+#define TRACE_HOT_PATH_LEVEL                TRACE_HOT_PATH_RING
+#endif
+#endif
+
+#define WPP_HOTPATH_LEVEL_FLAGS_LOGGER(hot, lvl, flags) \
+           WPP_LEVEL_LOGGER(flags)
+
+#define WPP_HOTPATH_LEVEL_FLAGS_ENABLED(hot, lvl, flags) \
+           (TRACE_HOT_PATH_LEVEL >= TRACE_HOT_PATH_FULL && WPP_LEVEL_FLAGS_ENABLED(lvl, flags))
+
+#define WPP_RECORDER_HOTPATH_LEVEL_FLAGS_ARGS(hot, lvl, flags) WPP_RECORDER_LEVEL_FLAGS_ARGS(lvl, flags)
+#define WPP_RECORDER_HOTPATH_LEVEL_FLAGS_FILTER(hot, lvl, flags) \
+           (TRACE_HOT_PATH_LEVEL >= TRACE_HOT_PATH_FULL && WPP_RECORDER_LEVEL_FLAGS_FILTER(lvl, flags))
+
 //
 // This comment block is scanned by the trace preprocessor to define our
 // Trace function.
 //
 // begin_wpp config
 // FUNC Trace(LEVEL, FLAGS, MSG, ...);
+// FUNC TraceHot{HOTPATH=1}(LEVEL, FLAGS, MSG, ...);
 // end_wpp
 //
 
+//
+// Hot path event ring, inspect gTraceHotRing from the debugger
+//
+#define TRACE_HOT_RING_SIZE                 256
+
+typedef enum _TRACE_HOT_EVENT_ID
+{
+	TRACE_HOT_ISR_ENTRY = 1,
+	TRACE_HOT_ISR_EXIT = 2,
+	TRACE_HOT_FIFO_READ = 3,
+	TRACE_HOT_FIFO_EVENT = 4,
+	TRACE_HOT_REPORT = 5,
+} TRACE_HOT_EVENT_ID;
+
+typedef struct _TRACE_HOT_EVENT
+{
+	ULONGLONG Timestamp;
+	ULONG EventId;
+	ULONG Data;
+} TRACE_HOT_EVENT;
+
+extern TRACE_HOT_EVENT gTraceHotRing[TRACE_HOT_RING_SIZE];
+extern volatile LONG gTraceHotRingIndex;
+
+#if TRACE_HOT_PATH_LEVEL >= TRACE_HOT_PATH_RING
+#define TraceHotRing(EVENTID, DATA)                                          \
+    do {                                                                    \
+        LONG _slot = InterlockedIncrement(&gTraceHotRingIndex) &             \
+            (TRACE_HOT_RING_SIZE - 1);                                      \
+        gTraceHotRing[_slot].Timestamp = KeQueryInterruptTime();            \
+        gTraceHotRing[_slot].EventId = (EVENTID);                           \
+        gTraceHotRing[_slot].Data = (ULONG)(DATA);                          \
+    } while (0)
+#else
+#define TraceHotRing(EVENTID, DATA)
+#endif
+
 #define Trace2(LEVEL, FLAGS, MSG, ...) \
     DbgPrintEx(DPFLTR_IHVDRIVER_ID, DPFLTR_ERROR_LEVEL, "STTouch: " MSG "\n", __VA_ARGS__);
\ No newline at end of file
@@ -45,7 +45,7 @@ static inline unsigned long __ffs(unsigned long word)
 {
 	int num = 0;
 
-#if defined(ARM64) || defined(AMD64)
+#if defined(ARM64) || defined(AMD64) || defined(__LP64__)
 	if ((word & 0xffffffff) == 0) {
 		num += 32;
 		word >>= 32;
@@ -22,7 +22,7 @@
 #include <internal.h>
 #include <controller.h>
 #include <device.h>
-#include <spb.h>
+#include <spbhelper.h>
 //#include <STTouchDriverETW.h>
 #include <idle.h>
 #include <hid.h>
@@ -70,7 +70,9 @@ OnInterruptIsr(
 
 	UNREFERENCED_PARAMETER(MessageID);
 
-	Trace(
+	TraceHotRing(TRACE_HOT_ISR_ENTRY, 0);
+
+	TraceHot(
 		TRACE_LEVEL_ERROR,
 		TRACE_REPORTING,
 		"OnInterruptIsr - Entry");
@@ -78,6 +80,8 @@ OnInterruptIsr(
 	status = STATUS_SUCCESS;
 	devContext = GetDeviceContext(WdfInterruptGetDevice(Interrupt));
 
+	LatencyStartFrame(&devContext->ReportContext.Latency);
+
 	//
 	// For performance tracing, write an ETW event marker
 	//
@@ -112,11 +116,15 @@ OnInterruptIsr(
 
 exit:
 
-	Trace(
+	LatencyEndFrame(&devContext->ReportContext.Latency);
+
+	TraceHot(
 		TRACE_LEVEL_ERROR,
 		TRACE_REPORTING,
 		"OnInterruptIsr - Exit");
 
+	TraceHotRing(TRACE_HOT_ISR_EXIT, status);
+
 	return TRUE;
 }
 
@@ -319,6 +327,42 @@ Exit:
 	return status;
 }
 
+static VOID
+OnPrepareHardwareStepDone(
+	IN PCSTR Step,
+	IN OUT ULONG64* StepStart
+)
+/*++
+
+  Routine Description:
+
+	Traces how long a device start step took so that the contributors
+	to the boot time show up in the trace, and starts timing the next
+	step
+
+  Arguments:
+
+	Step - Name of the step that just completed
+	StepStart - Interrupt time the step started at, updated to now
+
+  Return Value:
+
+	None
+
+--*/
+{
+	ULONG64 now = KeQueryInterruptTime();
+
+	Trace(
+		TRACE_LEVEL_INFORMATION,
+		TRACE_INIT,
+		"OnPrepareHardware - %s took %llu us",
+		Step,
+		(now - *StepStart) / 10);
+
+	*StepStart = now;
+}
+
 NTSTATUS
 OnPrepareHardware(
 	IN WDFDEVICE FxDevice,
@@ -354,6 +398,10 @@ OnPrepareHardware(
 	ULONG i;
 	LARGE_INTEGER delay;
 	unsigned char value;
+	ULONG64 prepareStart;
+	ULONG64 stepStart;
+	ULONG64 resetReleaseTime = 0;
+	ULONG64 elapsed;
 
 	UNREFERENCED_PARAMETER(FxResourcesRaw);
 
@@ -362,6 +410,9 @@ OnPrepareHardware(
 		TRACE_INIT,
 		"OnPrepareHardware - Entry");
 
+	prepareStart = KeQueryInterruptTime();
+	stepStart = prepareStart;
+
 	//EventRegisterMicrosoft_WindowsPhone_TouchMiniDriver();
 
 	status = STATUS_INSUFFICIENT_RESOURCES;
@@ -412,6 +463,25 @@ OnPrepareHardware(
 		goto exit;
 	}
 
+	//
+	// Initialize Spb so the driver can issue reads/writes, the bring up
+	// sequence polls the controller through it
+	//
+	status = SpbTargetInitialize(FxDevice, &devContext->I2CContext);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_INIT,
+			"Error in Spb initialization - 0x%08lX",
+			status);
+
+		goto exit;
+	}
+
+	OnPrepareHardwareStepDone("SpbTargetInitialize", &stepStart);
+
 	if (devContext->HasResetGpio)
 	{
 		status = OpenIOTarget(devContext, devContext->ResetGpioId, GENERIC_READ | GENERIC_WRITE, &devContext->ResetGpio);
@@ -437,117 +507,166 @@ OnPrepareHardware(
 		value = 1;
 		SetGPIO(devContext->ResetGpio, &value);
 
-		Trace(TRACE_LEVEL_INFORMATION, TRACE_DRIVER, "Waiting...");
+		resetReleaseTime = KeQueryInterruptTime();
 
-		delay.QuadPart = -10 * TOUCH_DELAY_TO_COMMUNICATE;
-		KeDelayExecutionThread(KernelMode, TRUE, &delay);
+		Trace(TRACE_LEVEL_INFORMATION, TRACE_DRIVER, "Controller booting");
 
-		Trace(TRACE_LEVEL_INFORMATION, TRACE_DRIVER, "Done");
+		OnPrepareHardwareStepDone("Reset", &stepStart);
 	}
 
 	//
-	// Initialize Spb so the driver can issue reads/writes
+	// Get screen properties and populate context. The steps up to the
+	// controller ready wait do not access the controller, they run
+	// while it boots.
 	//
-	status = SpbTargetInitialize(FxDevice, &devContext->I2CContext);
+	TchGetScreenProperties(&devContext->ReportContext.Props);
+
+	TchBuildTranslation(
+		&devContext->ReportContext.Translation,
+		&devContext->ReportContext.Props);
+
+	OnPrepareHardwareStepDone("TchGetScreenProperties", &stepStart);
+
+	//
+	// Prepare the hardware for touch scanning
+	//
+	status = TchAllocateContext(&devContext->TouchContext, FxDevice);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_INIT,
-			"Error in Spb initialization - 0x%08lX",
+			"Error allocating touch context - 0x%08lX",
 			status);
 
 		goto exit;
 	}
 
+	OnPrepareHardwareStepDone("TchAllocateContext", &stepStart);
+
 	//
-	// Initialize Touch Power so the driver can issue power state changes
+	// Fetch controller settings from registry
 	//
-	status = PowerInitialize(FxDevice);
+	status = TchRegistryGetControllerSettings(
+		devContext->TouchContext,
+		devContext->FxDevice);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_INIT,
-			"Error in touch power initialization - 0x%08lX",
+			"Error retrieving controller settings from registry - 0x%08lX",
 			status);
 
 		goto exit;
 	}
 
-	//
-	// Get screen properties and populate context
-	//
-	TchGetScreenProperties(&devContext->ReportContext.Props);
+	OnPrepareHardwareStepDone("TchRegistryGetControllerSettings", &stepStart);
 
 	//
-	// Prepare the hardware for touch scanning
+	// Configure the timer for continuous simulation on st hardware that doesn't support it
 	//
-	status = TchAllocateContext(&devContext->TouchContext, FxDevice);
+	status = ReportConfigureContinuousSimulationTimer(
+		devContext->FxDevice,
+		&devContext->ReportContext);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_INIT,
-			"Error allocating touch context - 0x%08lX",
+			"Error configuring continuous timer - 0x%08lX",
 			status);
 
 		goto exit;
 	}
 
+	OnPrepareHardwareStepDone("ReportConfigureContinuousSimulationTimer", &stepStart);
+
+	if (devContext->HasResetGpio)
+	{
+		//
+		// The boot time bound runs from the reset release, the time spent
+		// above counts against it
+		//
+		elapsed = (KeQueryInterruptTime() - resetReleaseTime) / 10;
+
+		Trace(TRACE_LEVEL_INFORMATION, TRACE_DRIVER, "Waiting for the controller to be ready...");
+
+		status = TchWaitForControllerReady(
+			&devContext->I2CContext,
+			elapsed < TOUCH_DELAY_TO_COMMUNICATE ? (ULONG)(TOUCH_DELAY_TO_COMMUNICATE - elapsed) : 0);
+
+		if (!NT_SUCCESS(status))
+		{
+			//
+			// Some firmwares do not queue the ready event, the full delay
+			// has elapsed by now so carry on as before
+			//
+			Trace(TRACE_LEVEL_WARNING, TRACE_DRIVER, "No controller ready event - 0x%x", status);
+		}
+
+		Trace(TRACE_LEVEL_INFORMATION, TRACE_DRIVER, "Done");
+
+		OnPrepareHardwareStepDone("TchWaitForControllerReady", &stepStart);
+	}
+
 	//
-	// Fetch controller settings from registry
+	// Initialize Touch Power so the driver can issue power state changes
 	//
-	status = TchRegistryGetControllerSettings(
-		devContext->TouchContext,
-		devContext->FxDevice);
+	status = PowerInitialize(FxDevice);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_INIT,
-			"Error retrieving controller settings from registry - 0x%08lX",
+			"Error in touch power initialization - 0x%08lX",
 			status);
 
 		goto exit;
 	}
 
+	OnPrepareHardwareStepDone("PowerInitialize", &stepStart);
+
 	//
-	// Configure the timer for continuous simulation on st hardware that doesn't support it
+	// Start the controller
 	//
-	status = ReportConfigureContinuousSimulationTimer(devContext->FxDevice);
+	status = TchStartDevice(devContext->TouchContext, &devContext->I2CContext);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_INIT,
-			"Error configuring continuous timer - 0x%08lX",
+			"Error starting touch device - 0x%08lX",
 			status);
 
 		goto exit;
 	}
 
+	OnPrepareHardwareStepDone("TchStartDevice", &stepStart);
+
 	//
-	// Start the controller
+	// Cache the wakeup gesture setting for the display state callback
 	//
-	status = TchStartDevice(devContext->TouchContext, &devContext->I2CContext);
+	status = TchWakeupGestureCacheInitialize(devContext);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_INIT,
-			"Error starting touch device - 0x%08lX",
+			"Error caching wakeup gesture setting - 0x%08lX",
 			status);
 
 		goto exit;
 	}
 
+	OnPrepareHardwareStepDone("TchWakeupGestureCacheInitialize", &stepStart);
+
 	status = PoRegisterPowerSettingCallback(
 		NULL,
 		&GUID_ACDC_POWER_SOURCE,
@@ -591,8 +710,9 @@ exit:
 	Trace(
 		TRACE_LEVEL_INFORMATION,
 		TRACE_INIT,
-		"OnPrepareHardware - Exit - 0x%08lX",
-		status);
+		"OnPrepareHardware - Exit - 0x%08lX after %llu us",
+		status,
+		(KeQueryInterruptTime() - prepareStart) / 10);
 
 	return status;
 }
@@ -660,6 +780,8 @@ OnReleaseHardware(
 			status);
 	}
 
+	TchWakeupGestureCacheDeinitialize(devContext);
+
 	status = TchStopDevice(devContext->TouchContext, &devContext->I2CContext);
 
 	if (!NT_SUCCESS(status))
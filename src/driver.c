@@ -30,6 +30,12 @@
 #include <driver.h>
 #include <driver.tmh>
 
+//
+// Hot path event ring, see TraceHotRing
+//
+TRACE_HOT_EVENT gTraceHotRing[TRACE_HOT_RING_SIZE];
+volatile LONG gTraceHotRingIndex = -1;
+
 #ifdef ALLOC_PRAGMA
 #pragma alloc_text(PAGE, OnDeviceAdd)
 #pragma alloc_text(PAGE, OnContextCleanup)
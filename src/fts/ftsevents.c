@@ -19,7 +19,7 @@
 --*/
 
 #include <Cross Platform Shim\compat.h>
-#include <spb.h>
+#include <spbhelper.h>
 #include <report.h>
 #include <fts\ftsinternal.h>
 #include <fts\ftsregs.h>
@@ -27,24 +27,74 @@
 #include <fts\ftsevents.h>
 #include <ftsevents.tmh>
 
+//
+// A full FIFO read must fit the FIFO size class of the SPB buffer pool
+//
+C_ASSERT(SPB_FIFO_BUFFER_SIZE >= FIFO_DEPTH * FIFO_EVENT_SIZE + 1);
+
+//
+// A saturated count must still fit the FIFO so it can be read whole
+//
+C_ASSERT(EVENT_LEFT_EVENTS_SATURATED + 1 <= FIFO_DEPTH);
+
+/*
+	@brief Checks whether a read covering the whole FIFO found it full
+	The FIFO drops the events that arrive while all its entries are in
+	use, so a valid event in its last entry means events were lost and
+	the controller has to be resynchronized
+
+	@param ControllerContext - A pointer to the current touch controller context
+	@param EventCount - Number of FIFO entries read into EventBuffer
+*/
+static VOID FtsCheckFifoFull(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	DWORD EventCount)
+{
+	if (EventCount < FIFO_DEPTH ||
+		ControllerContext->EventBuffer[(FIFO_DEPTH - 1) * FIFO_EVENT_SIZE] == EVENTID_NO_EVENT)
+	{
+		return;
+	}
+
+	ControllerContext->FifoOverflows++;
+	ControllerContext->ResyncPending = TRUE;
+
+	Trace(
+		TRACE_LEVEL_ERROR,
+		TRACE_INTERRUPT,
+		"FtsCheckFifoFull - FIFO full, events lost, %d overflows so far",
+		ControllerContext->FifoOverflows);
+}
+
 /*
 	@brief Reads all events from the FIFO buffer
-	The caller is responsible for freeing the memory returned by this function
+	The returned buffer is ControllerContext->EventBuffer and stays valid
+	until the next call, the caller must not free it
 
+	The first transaction speculatively reads a batch of
+	ControllerContext->FifoSpeculativeEvents events so that the common case
+	of a few pending events costs a single bus transaction. A second read is
+	only issued when the first event reports more pending events than the
+	batch could hold.
+
+	@param ControllerContext - A pointer to the current touch controller context
 	@param SpbContext - A pointer to the current i2c context
 	@param DataBuffer - A pointer to the buffer that will contain the events
 	@param DataBufferLength - The length of the buffer
 	@return NTSTATUS
 */
 NTSTATUS FtsGetAllEvents(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
 	SPB_CONTEXT* SpbContext,
 	BYTE** DataBuffer,
 	DWORD* DataBufferLength)
 {
 	NTSTATUS status;
-	BYTE* allEventsBuffer = NULL;
+	BYTE* eventBuffer;
+	DWORD batchEvents;
+	DWORD totalEvents;
 
-	Trace(
+	TraceHot(
 		TRACE_LEVEL_ERROR,
 		TRACE_REPORTING,
 		"FtsGetAllEvents - Entry");
@@ -55,105 +105,111 @@ NTSTATUS FtsGetAllEvents(
 		goto exit;
 	}
 
-	*DataBuffer = ExAllocatePoolWithTag(
-		NonPagedPoolNx,
-		FIFO_EVENT_SIZE,
-		TOUCH_POOL_TAG_F12
-	);
+	*DataBuffer = NULL;
+	*DataBufferLength = 0;
+
+	eventBuffer = ControllerContext->EventBuffer;
+	batchEvents = ControllerContext->FifoSpeculativeEvents;
 
-	if (*DataBuffer == NULL)
+	if (batchEvents == 0)
 	{
-		status = STATUS_INSUFFICIENT_RESOURCES;
-		*DataBufferLength = 0;
-		goto exit;
+		batchEvents = 1;
+	}
+	else if (batchEvents > FIFO_DEPTH)
+	{
+		batchEvents = FIFO_DEPTH;
 	}
 
-	*DataBufferLength = FIFO_EVENT_SIZE;
+	//
+	// A batch of one keeps the original single event read, larger batches
+	// read as many events as the batch holds in one transaction
+	//
+	status = SpbReadDataSynchronously(
+		SpbContext,
+		batchEvents == 1 ? FIFO_CMD_READONE : FIFO_CMD_READALL,
+		eventBuffer,
+		batchEvents * FIFO_EVENT_SIZE);
 
-	status = SpbReadDataSynchronously(SpbContext, FIFO_CMD_READONE, *DataBuffer, FIFO_EVENT_SIZE);
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_INTERRUPT,
-			"FtsGetAllEvents - Error reading one event from the chip - 0x%08lX",
+			"FtsGetAllEvents - Error reading events from the chip - 0x%08lX",
 			status);
 
-		ExFreePoolWithTag(
-			*DataBuffer,
-			TOUCH_POOL_TAG_F12
-		);
-
-		*DataBuffer = NULL;
-		*DataBufferLength = 0;
-
 		goto exit;
 	}
 
-	// 00011111
-	DWORD leftEvents = (*DataBuffer)[7] & 0x1F;
+	*DataBuffer = eventBuffer;
 
-	Trace(
+	DWORD leftEvents = EVENT_LEFT_EVENTS(eventBuffer);
+
+	TraceHot(
 		TRACE_LEVEL_ERROR,
 		TRACE_REPORTING,
 		"FtsGetAllEvents - %d events detected",
 		leftEvents + 1);
 
-	if ((leftEvents > 0) && (leftEvents < FIFO_DEPTH))
+	if (leftEvents == EVENT_LEFT_EVENTS_SATURATED)
 	{
-		allEventsBuffer = ExAllocatePoolWithTag(
-			NonPagedPoolNx,
-			(leftEvents + 1) * FIFO_EVENT_SIZE,
-			TOUCH_POOL_TAG_F12
-		);
-
-		if (allEventsBuffer == NULL)
-		{
-			// Process the one that was fine instead
-			// 11100000
-			(*DataBuffer)[7] &= 0xE0;
+		//
+		// More events are pending than the count can tell, read
+		// everything the FIFO holds. Only a FIFO found full lost events.
+		//
+		leftEvents = FIFO_DEPTH - 1;
+	}
 
-			goto exit;
-		}
+	totalEvents = leftEvents + 1;
 
-		status = SpbReadDataSynchronously(SpbContext, FIFO_CMD_READALL, allEventsBuffer + FIFO_EVENT_SIZE, leftEvents * FIFO_EVENT_SIZE);
-		if (!NT_SUCCESS(status))
-		{
-			Trace(
-				TRACE_LEVEL_ERROR,
-				TRACE_INTERRUPT,
-				"FtsGetAllEvents - Error reading all remaining events - 0x%08lX",
-				status);
+	TraceHotRing(TRACE_HOT_FIFO_READ, totalEvents);
 
-			// Process the one that was fine instead
-			// 11100000
-			(*DataBuffer)[7] &= 0xE0;
+	//
+	// Everything pending fit in the speculative batch. The read popped
+	// the whole batch from the FIFO, entries past the reported count are
+	// either empty and decode as EVENTID_NO_EVENT, or events that arrived
+	// after the count was taken, so the whole batch is processed.
+	//
+	if (totalEvents <= batchEvents)
+	{
+		*DataBufferLength = batchEvents * FIFO_EVENT_SIZE;
+		FtsCheckFifoFull(ControllerContext, batchEvents);
+		goto exit;
+	}
 
-			status = STATUS_SUCCESS;
+	*DataBufferLength = batchEvents * FIFO_EVENT_SIZE;
 
-			ExFreePoolWithTag(
-				allEventsBuffer,
-				TOUCH_POOL_TAG_F12
-			);
-		}
-		else
-		{
-			// Copy the first event
-			RtlCopyMemory(allEventsBuffer, *DataBuffer, FIFO_EVENT_SIZE);
+	//
+	// Start reading the remaining events and let the caller decode the
+	// batch meanwhile, FtsWaitForRemainingEvents picks up the result
+	//
+	status = SpbReadDataAsynchronously(
+		SpbContext,
+		FIFO_CMD_READALL,
+		eventBuffer + batchEvents * FIFO_EVENT_SIZE,
+		(totalEvents - batchEvents) * FIFO_EVENT_SIZE,
+		NULL,
+		NULL);
 
-			ExFreePoolWithTag(
-				*DataBuffer,
-				TOUCH_POOL_TAG_F12
-			);
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_INTERRUPT,
+			"FtsGetAllEvents - Error reading all remaining events - 0x%08lX",
+			status);
 
-			*DataBuffer = allEventsBuffer;
-			allEventsBuffer = NULL;
-			*DataBufferLength = (leftEvents + 1) * FIFO_EVENT_SIZE;
-		}
+		// Process the batch that was fine instead
+		ControllerContext->ResyncPending = TRUE;
+		status = STATUS_SUCCESS;
+	}
+	else
+	{
+		ControllerContext->EventTailLength = (totalEvents - batchEvents) * FIFO_EVENT_SIZE;
 	}
 
 exit:
-	Trace(
+	TraceHot(
 		TRACE_LEVEL_ERROR,
 		TRACE_REPORTING,
 		"FtsGetAllEvents - Exit");
@@ -161,6 +217,202 @@ exit:
 	return status;
 }
 
+/*
+	@brief Waits for the remaining events started by FtsGetAllEvents
+	Must be called before any other i2c access once FtsGetAllEvents
+	returned, does nothing if all events were read already
+
+	@param ControllerContext - A pointer to the current touch controller context
+	@param SpbContext - A pointer to the current i2c context
+	@param DataBufferLength - The length of the buffer, updated to include
+	the remaining events once they were read
+	@return NTSTATUS
+*/
+NTSTATUS FtsWaitForRemainingEvents(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	SPB_CONTEXT* SpbContext,
+	DWORD* DataBufferLength)
+{
+	NTSTATUS status = STATUS_SUCCESS;
+
+	if (ControllerContext->EventTailLength == 0)
+	{
+		goto exit;
+	}
+
+	status = SpbWaitForAsynchronousRead(SpbContext);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_INTERRUPT,
+			"FtsWaitForRemainingEvents - Error reading all remaining events - 0x%08lX",
+			status);
+
+		ControllerContext->ResyncPending = TRUE;
+	}
+	else
+	{
+		*DataBufferLength += ControllerContext->EventTailLength;
+		FtsCheckFifoFull(ControllerContext, *DataBufferLength / FIFO_EVENT_SIZE);
+	}
+
+	ControllerContext->EventTailLength = 0;
+
+exit:
+	return status;
+}
+
+static NTSTATUS
+FtsProcessNoEvent(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	PREPORT_CONTEXT ReportContext,
+	BYTE* EventData
+)
+{
+	UNREFERENCED_PARAMETER(ControllerContext);
+	UNREFERENCED_PARAMETER(ReportContext);
+	UNREFERENCED_PARAMETER(EventData);
+
+	return STATUS_SUCCESS;
+}
+
+static NTSTATUS
+FtsProcessErrorEvent(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	PREPORT_CONTEXT ReportContext,
+	BYTE* EventData
+)
+{
+	UNREFERENCED_PARAMETER(ReportContext);
+
+	Trace(
+		TRACE_LEVEL_ERROR,
+		TRACE_INTERRUPT,
+		"FtsProcessOneEvent - Controller error %02X %02X %02X %02X %02X %02X",
+		EventData[1],
+		EventData[2],
+		EventData[3],
+		EventData[4],
+		EventData[5],
+		EventData[6]);
+
+	//
+	// The controller reports lost events and internal failures such as
+	// ESD recoveries through this event, the contacts it reported before
+	// can no longer be trusted
+	//
+	ControllerContext->ResyncPending = TRUE;
+
+	return STATUS_SUCCESS;
+}
+
+static NTSTATUS
+FtsProcessControllerReadyEvent(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	PREPORT_CONTEXT ReportContext,
+	BYTE* EventData
+)
+{
+	UNREFERENCED_PARAMETER(ReportContext);
+
+	Trace(
+		TRACE_LEVEL_WARNING,
+		TRACE_INTERRUPT,
+		"FtsProcessOneEvent - Controller ready (event 0x%02X), re-arming interrupts",
+		EventData[0]);
+
+	//
+	// The controller went through a reset and lost its interrupt enable
+	// configuration, TchServiceObjectInterrupts re-arms it
+	//
+	ControllerContext->InterruptEnablePending = TRUE;
+
+	return STATUS_SUCCESS;
+}
+
+static NTSTATUS
+FtsProcessStatusEvent(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	PREPORT_CONTEXT ReportContext,
+	BYTE* EventData
+)
+{
+	UNREFERENCED_PARAMETER(ControllerContext);
+	UNREFERENCED_PARAMETER(ReportContext);
+
+	Trace(
+		TRACE_LEVEL_INFORMATION,
+		TRACE_INTERRUPT,
+		"FtsProcessOneEvent - Controller status %02X %02X %02X %02X %02X %02X",
+		EventData[1],
+		EventData[2],
+		EventData[3],
+		EventData[4],
+		EventData[5],
+		EventData[6]);
+
+	return STATUS_SUCCESS;
+}
+
+static NTSTATUS
+FtsProcessGestureEvent(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	PREPORT_CONTEXT ReportContext,
+	BYTE* EventData
+)
+{
+	UNREFERENCED_PARAMETER(ControllerContext);
+
+	Trace(
+		TRACE_LEVEL_INFORMATION,
+		TRACE_INTERRUPT,
+		"FtsProcessOneEvent - Gesture %02X",
+		EventData[1]);
+
+	return ReportWakeup(ReportContext);
+}
+
+static NTSTATUS
+FtsProcessButtonStatusEvent(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	PREPORT_CONTEXT ReportContext,
+	BYTE* EventData
+)
+{
+	UNREFERENCED_PARAMETER(ControllerContext);
+
+	return ReportKeypad(
+		ReportContext,
+		EVENT_BUTTON_BACK(EventData),
+		EVENT_BUTTON_START(EventData),
+		EVENT_BUTTON_SEARCH(EventData));
+}
+
+typedef NTSTATUS
+(*PFTS_EVENT_HANDLER)(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	PREPORT_CONTEXT ReportContext,
+	BYTE* EventData
+);
+
+//
+// Handlers for the events that are not pointer events, indexed by event
+// ID. Pointer events are decoded by FtsDecodePointerEvents, other events
+// without a handler are logged and discarded.
+//
+static const PFTS_EVENT_HANDLER gFtsEventHandlers[EVENTID_LAST] =
+{
+	[EVENTID_NO_EVENT] = FtsProcessNoEvent,
+	[EVENTID_BUTTON_STATUS] = FtsProcessButtonStatusEvent,
+	[EVENTID_ERROR] = FtsProcessErrorEvent,
+	[EVENTID_CONTROLLER_READY] = FtsProcessControllerReadyEvent,
+	[EVENTID_SLEEPOUT_CONTROLLER_READY] = FtsProcessControllerReadyEvent,
+	[EVENTID_STATUS] = FtsProcessStatusEvent,
+	[EVENTID_GESTURE] = FtsProcessGestureEvent,
+};
+
 NTSTATUS
 FtsProcessOneEvent(
 	FTS_CONTROLLER_CONTEXT* ControllerContext,
@@ -171,73 +423,248 @@ FtsProcessOneEvent(
 	NTSTATUS status = STATUS_SUCCESS;
 
 	BYTE EventID = EventData[0];
+	PFTS_EVENT_HANDLER handler = gFtsEventHandlers[EventID];
 
-	switch (EventID)
-	{
-	case EVENTID_ENTER_POINTER:
+	TraceHotRing(TRACE_HOT_FIFO_EVENT, EventID | (EventData[2] << 8));
+
+	if (handler == NULL)
 	{
-		status = FtsProcessEnterPointerEvent(ControllerContext, ReportContext, EventData);
-		if (!NT_SUCCESS(status))
-		{
-			Trace(
-				TRACE_LEVEL_VERBOSE,
-				TRACE_SAMPLES,
-				"FtsProcessOneEvent - Error while processing enter pointer event - 0x%08lX",
-				status);
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_REPORTING,
+			"FtsProcessOneEvent - Unknown event id %d",
+			EventID);
+		goto exit;
+	}
 
-			goto exit;
-		}
+	status = handler(ControllerContext, ReportContext, EventData);
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_VERBOSE,
+			TRACE_SAMPLES,
+			"FtsProcessOneEvent - Error while processing event id %d - 0x%08lX",
+			EventID,
+			status);
 
-		break;
+		goto exit;
 	}
-	case EVENTID_MOTION_POINTER:
+
+exit:
+
+	TraceHot(
+		TRACE_LEVEL_ERROR,
+		TRACE_REPORTING,
+		"FtsProcessOneEvent - Exit - 0x%08lX",
+		status);
+
+	return status;
+}
+
+static NTSTATUS
+FtsProcessEvents(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	PREPORT_CONTEXT ReportContext,
+	BYTE* EventDataBuffer,
+	DWORD FirstEvent,
+	DWORD LastEvent
+)
+/*++
+
+Routine Description:
+
+	Processes the events FirstEvent to LastEvent of a buffer in FIFO
+	order. The pointer events of every FIFO_DEPTH chunk are decoded in one
+	pass, then applied run by run, each run being followed by the other
+	event that ended it.
+
+Arguments:
+
+	ControllerContext - Touch controller context
+	ReportContext - Report context
+	EventDataBuffer - The events, FIFO_EVENT_SIZE bytes each
+	FirstEvent - Index of the first event to process
+	LastEvent - Index past the last event to process
+
+Return Value:
+
+	NTSTATUS indicating success or failure
+
+--*/
+{
+	NTSTATUS status = STATUS_SUCCESS;
+	FTS_POINTER_BATCH* batch = &ControllerContext->PointerBatch;
+	BYTE* chunk;
+	DWORD chunkEvents;
+	DWORD applied;
+	DWORD othersSeen;
+	unsigned long i;
+
+	while (FirstEvent < LastEvent)
 	{
-		status = FtsProcessMotionPointerEvent(ControllerContext, ReportContext, EventData);
-		if (!NT_SUCCESS(status))
+		chunk = EventDataBuffer + FirstEvent * FIFO_EVENT_SIZE;
+		chunkEvents = min(LastEvent - FirstEvent, FIFO_DEPTH);
+
+		TraceHot(
+			TRACE_LEVEL_ERROR,
+			TRACE_REPORTING,
+			"TchServiceObjectInterrupts - Processing events %d to %d",
+			FirstEvent,
+			FirstEvent + chunkEvents - 1);
+
+		FtsDecodePointerEvents(chunk, chunkEvents, batch);
+
+		LatencyRecord(&ReportContext->Latency, LATENCY_STAGE_DECODE);
+
+		applied = 0;
+		othersSeen = 0;
+
+		for_each_set_bit(i, batch->OtherEvents, chunkEvents)
 		{
-			Trace(
-				TRACE_LEVEL_VERBOSE,
-				TRACE_SAMPLES,
-				"FtsProcessOneEvent - Error while processing motion pointer event - 0x%08lX",
-				status);
-			goto exit;
+			//
+			// Apply the pointer events preceding this event first, they
+			// are the ones at indices below i that are not other events
+			//
+			status = FtsApplyPointerEvents(
+				ControllerContext,
+				ReportContext,
+				batch,
+				applied,
+				i - othersSeen);
+
+			if (!NT_SUCCESS(status))
+			{
+				Trace(
+					TRACE_LEVEL_ERROR,
+					TRACE_INTERRUPT,
+					"TchServiceObjectInterrupts - Error processing pointer events - 0x%08lX",
+					status);
+				goto exit;
+			}
+
+			applied = i - othersSeen;
+			othersSeen++;
+
+			//
+			// Events such as button presses and gestures send reports of
+			// their own, the coalesced pointer report goes out before them
+			//
+			if (chunk[i * FIFO_EVENT_SIZE] != EVENTID_NO_EVENT)
+			{
+				status = FtsFlushPointerReport(ControllerContext, ReportContext);
+				if (!NT_SUCCESS(status))
+				{
+					Trace(
+						TRACE_LEVEL_ERROR,
+						TRACE_INTERRUPT,
+						"TchServiceObjectInterrupts - Error reporting objects - 0x%08lX",
+						status);
+					goto exit;
+				}
+			}
+
+			status = FtsProcessOneEvent(ControllerContext, ReportContext, chunk + i * FIFO_EVENT_SIZE);
+			if (!NT_SUCCESS(status))
+			{
+				Trace(
+					TRACE_LEVEL_ERROR,
+					TRACE_INTERRUPT,
+					"TchServiceObjectInterrupts - Error processing event %d - 0x%08lX",
+					FirstEvent + i,
+					status);
+				goto exit;
+			}
 		}
 
-		break;
-	}
-	case EVENTID_LEAVE_POINTER:
-	{
-		status = FtsProcessLeavePointerEvent(ControllerContext, ReportContext, EventData);
+		status = FtsApplyPointerEvents(
+			ControllerContext,
+			ReportContext,
+			batch,
+			applied,
+			batch->Count);
+
 		if (!NT_SUCCESS(status))
 		{
 			Trace(
-				TRACE_LEVEL_VERBOSE,
-				TRACE_SAMPLES,
-				"FtsProcessOneEvent - Error while processing leave pointer event - 0x%08lX",
+				TRACE_LEVEL_ERROR,
+				TRACE_INTERRUPT,
+				"TchServiceObjectInterrupts - Error processing pointer events - 0x%08lX",
 				status);
 			goto exit;
 		}
 
-		break;
+		FirstEvent += chunkEvents;
 	}
-	default:
+
+exit:
+	return status;
+}
+
+static NTSTATUS
+FtsResynchronize(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	SPB_CONTEXT* SpbContext,
+	PREPORT_CONTEXT ReportContext
+)
+/*++
+
+Routine Description:
+
+	Recovers from lost FIFO events. The controller only reports contacts
+	through FIFO events and has no command to read back the contacts it
+	tracks, so the state can not be re-read after the flush. The stale
+	events left in the FIFO are flushed and a corrective frame lifts
+	every contact that is down. A contact still on the panel is reported
+	down again by its next motion event, which FtsUpdatePointerObject
+	treats as a new contact for a slot that is up.
+
+Arguments:
+
+	ControllerContext - Touch controller context
+	SpbContext - A pointer to the current i2c context
+	ReportContext - Report context
+
+Return Value:
+
+	NTSTATUS indicating success or failure
+
+--*/
+{
+	NTSTATUS status;
+
+	ControllerContext->ResyncPending = FALSE;
+	ControllerContext->FifoResyncs++;
+
+	Trace(
+		TRACE_LEVEL_WARNING,
+		TRACE_INTERRUPT,
+		"FtsResynchronize - Lifting contacts 0x%08X, %d resyncs so far",
+		ControllerContext->DetectedObjects.PresentMask,
+		ControllerContext->FifoResyncs);
+
+	status = SpbWriteDataSynchronously(SpbContext, FIFO_CMD_FLUSH, NULL, 0);
+	if (!NT_SUCCESS(status))
 	{
+		//
+		// Lifting the contacts matters more than the stale events, which
+		// only bring contacts back that are then lifted on their own
+		//
 		Trace(
 			TRACE_LEVEL_ERROR,
-			TRACE_REPORTING,
-			"FtsProcessOneEvent - Unknown event id %d",
-			EventID);
-		break;
-	}
+			TRACE_INTERRUPT,
+			"FtsResynchronize - Error flushing the FIFO - 0x%08lX",
+			status);
 	}
 
-exit:
-
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Exit - 0x%08lX",
-		status);
+	status = FtsLiftAllPointers(ControllerContext, ReportContext);
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_INTERRUPT,
+			"FtsResynchronize - Error reporting the corrective frame - 0x%08lX",
+			status);
+	}
 
 	return status;
 }
@@ -271,7 +698,7 @@ Return Value:
 	NTSTATUS status;
 	FTS_CONTROLLER_CONTEXT* controller;
 
-	Trace(
+	TraceHot(
 		TRACE_LEVEL_ERROR,
 		TRACE_REPORTING,
 		"TchServiceObjectInterrupts - Entry");
@@ -287,7 +714,7 @@ Return Value:
 	BYTE* EventDataBuffer = NULL;
 	DWORD EventDataBufferLength = 0;
 
-	status = FtsGetAllEvents(SpbContext, &EventDataBuffer, &EventDataBufferLength);
+	status = FtsGetAllEvents(controller, SpbContext, &EventDataBuffer, &EventDataBufferLength);
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
@@ -308,62 +735,179 @@ Return Value:
 		goto exit;
 	}
 
-	DWORD TotalEvents = EventDataBufferLength / FIFO_EVENT_SIZE;
+	LatencyRecord(&ReportContext->Latency, LATENCY_STAGE_FIFO_READ);
+
+	DWORD BatchEvents = EventDataBufferLength / FIFO_EVENT_SIZE;
+
+	// Process the events read so far while the remaining ones are read
+	status = FtsProcessEvents(
+		controller,
+		ReportContext,
+		EventDataBuffer,
+		0,
+		BatchEvents);
 
-	// Process all events
-	for (DWORD CurrentEventId = 0; CurrentEventId < TotalEvents; CurrentEventId++) {
+	// Always collect the remaining events, the i2c bus stays busy until then
+	if (NT_SUCCESS(FtsWaitForRemainingEvents(controller, SpbContext, &EventDataBufferLength)) &&
+		NT_SUCCESS(status))
+	{
+		status = FtsProcessEvents(
+			controller,
+			ReportContext,
+			EventDataBuffer,
+			BatchEvents,
+			EventDataBufferLength / FIFO_EVENT_SIZE);
+	}
 
-		DWORD i = CurrentEventId * FIFO_EVENT_SIZE;
+	if (!NT_SUCCESS(status))
+	{
+		goto exit;
+	}
 
+	// Report the state left by the whole batch
+	status = FtsFlushPointerReport(controller, ReportContext);
+	if (!NT_SUCCESS(status))
+	{
 		Trace(
 			TRACE_LEVEL_ERROR,
-			TRACE_REPORTING,
-			"TchServiceObjectInterrupts - Processing event %d",
-			CurrentEventId);
+			TRACE_INTERRUPT,
+			"TchServiceObjectInterrupts - Error reporting objects - 0x%08lX",
+			status);
+		goto exit;
+	}
 
-		// Process the event
-		status = FtsProcessOneEvent(controller, ReportContext, EventDataBuffer + i);
+	if (controller->ResyncPending)
+	{
+		status = FtsResynchronize(controller, SpbContext, ReportContext);
+		if (!NT_SUCCESS(status))
+		{
+			goto exit;
+		}
+	}
+
+	// Re-enable interrupts, only needed when the chip family is unknown
+	// or the controller lost its configuration
+	if (controller->InterruptEnablePending)
+	{
+		status = FtsConfigureInterruptEnable(ControllerContext, SpbContext);
 		if (!NT_SUCCESS(status))
 		{
 			Trace(
 				TRACE_LEVEL_ERROR,
 				TRACE_INTERRUPT,
-				"TchServiceObjectInterrupts - Error processing event %d - 0x%08lX",
-				CurrentEventId,
+				"TchServiceObjectInterrupts - Error enabling interrupts - 0x%08lX",
 				status);
-			goto free_buffer;
+			goto exit;
 		}
 	}
 
-	// Re-enable interrupts
-	status = FtsConfigureInterruptEnable(ControllerContext, SpbContext);
-	if (!NT_SUCCESS(status))
+exit:
+	TraceHot(
+		TRACE_LEVEL_ERROR,
+		TRACE_REPORTING,
+		"TchServiceObjectInterrupts - Exit\n");
+
+	return status;
+}
+
+NTSTATUS
+TchReplayObjectEvents(
+	IN FTS_CONTROLLER_CONTEXT* ControllerContext,
+	IN PREPORT_CONTEXT ReportContext,
+	IN BYTE* EventData,
+	IN DWORD EventDataLength
+)
+/*++
+
+Routine Description:
+
+	This routine runs previously recorded FIFO events through the same
+	decode and report path as TchServiceObjectInterrupts, without touching
+	the hardware. The resulting HID reports are delivered to HIDClass.
+
+	The events are replayed into a scratch controller context that starts
+	without contacts and shares only the configuration of the device, so
+	the live contacts and the flags that drive the hardware, such as
+	ResyncPending and InterruptEnablePending, are left alone. Contacts the
+	replay leaves down are lifted before returning.
+
+Arguments:
+
+	ControllerContext - Touch controller context
+	ReportContext - Report context
+	EventData - Recorded events, FIFO_EVENT_SIZE bytes each
+	EventDataLength - Length of the recorded events
+
+Return Value:
+
+	NTSTATUS indicating success or failure
+
+--*/
+{
+	NTSTATUS status;
+	NTSTATUS liftStatus;
+	FTS_CONTROLLER_CONTEXT* replay = NULL;
+
+	Trace(
+		TRACE_LEVEL_INFORMATION,
+		TRACE_REPORTING,
+		"TchReplayObjectEvents - Entry");
+
+	if (EventDataLength % FIFO_EVENT_SIZE != 0)
 	{
-		Trace(
-			TRACE_LEVEL_ERROR,
-			TRACE_INTERRUPT,
-			"TchServiceObjectInterrupts - Error enabling interrupts - 0x%08lX",
-			status);
-		goto free_buffer;
+		status = STATUS_INVALID_PARAMETER;
+		goto exit;
 	}
 
-free_buffer:
-	if (EventDataBuffer != NULL)
+	replay = ExAllocatePoolWithTag(
+		NonPagedPoolNx,
+		sizeof(FTS_CONTROLLER_CONTEXT),
+		TOUCH_POOL_TAG);
+
+	if (replay == NULL)
 	{
-		ExFreePoolWithTag(
-			EventDataBuffer,
-			TOUCH_POOL_TAG_F12
-		);
+		status = STATUS_INSUFFICIENT_RESOURCES;
+		goto exit;
+	}
+
+	RtlZeroMemory(replay, sizeof(FTS_CONTROLLER_CONTEXT));
+
+	WdfWaitLockAcquire(ControllerContext->ControllerLock, NULL);
 
-		EventDataBuffer = NULL;
-		EventDataBufferLength = 0;
+	replay->FxDevice = ControllerContext->FxDevice;
+	replay->MaxFingers = ControllerContext->MaxFingers;
+	replay->ChipFamily = ControllerContext->ChipFamily;
+	replay->FifoSpeculativeEvents = ControllerContext->FifoSpeculativeEvents;
+	replay->CoalesceReports = ControllerContext->CoalesceReports;
+
+	status = FtsProcessEvents(
+		replay,
+		ReportContext,
+		EventData,
+		0,
+		EventDataLength / FIFO_EVENT_SIZE);
+
+	if (NT_SUCCESS(status))
+	{
+		status = FtsFlushPointerReport(replay, ReportContext);
 	}
 
+	liftStatus = FtsLiftAllPointers(replay, ReportContext);
+	if (NT_SUCCESS(status))
+	{
+		status = liftStatus;
+	}
+
+	WdfWaitLockRelease(ControllerContext->ControllerLock);
+
+	ExFreePoolWithTag(replay, TOUCH_POOL_TAG);
+
 exit:
 	Trace(
-		TRACE_LEVEL_ERROR,
+		TRACE_LEVEL_INFORMATION,
 		TRACE_REPORTING,
-		"TchServiceObjectInterrupts - Exit\n");
+		"TchReplayObjectEvents - Exit - 0x%08lX",
+		status);
 
 	return status;
 }
@@ -393,7 +937,7 @@ TchClearObjectInterrupts(
 	BYTE* EventDataBuffer = NULL;
 	DWORD EventDataBufferLength = 0;
 
-	status = FtsGetAllEvents(SpbContext, &EventDataBuffer, &EventDataBufferLength);
+	status = FtsGetAllEvents(controller, SpbContext, &EventDataBuffer, &EventDataBufferLength);
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
@@ -404,6 +948,16 @@ TchClearObjectInterrupts(
 		goto exit;
 	}
 
+	FtsWaitForRemainingEvents(controller, SpbContext, &EventDataBufferLength);
+
+	//
+	// The drained events are discarded, a full FIFO or a failed read
+	// during the drain must not resynchronize on the first live interrupt
+	// and flush its events
+	//
+	controller->ResyncPending = FALSE;
+	controller->PendingPresenceMask = 0;
+
 	if (EventDataBuffer == NULL || EventDataBufferLength == 0)
 	{
 		Trace(
@@ -423,19 +977,7 @@ TchClearObjectInterrupts(
 			TRACE_INTERRUPT,
 			"TchClearObjectInterrupts - Error enabling interrupts - 0x%08lX",
 			status);
-		goto free_buffer;
-	}
-
-free_buffer:
-	if (EventDataBuffer != NULL)
-	{
-		ExFreePoolWithTag(
-			EventDataBuffer,
-			TOUCH_POOL_TAG_F12
-		);
-
-		EventDataBuffer = NULL;
-		EventDataBufferLength = 0;
+		goto exit;
 	}
 
 exit:
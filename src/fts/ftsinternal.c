@@ -19,7 +19,7 @@
 --*/
 
 #include <Cross Platform Shim\compat.h>
-#include <spb.h>
+#include <spbhelper.h>
 #include <report.h>
 #include <fts\ftsregs.h>
 #include <fts\ftsevents.h>
@@ -36,7 +36,7 @@ FtsServiceInterrupts(
 	NTSTATUS status = STATUS_NO_DATA_DETECTED;
 	FTS_CONTROLLER_CONTEXT* controller;
 
-	Trace(
+	TraceHot(
 		TRACE_LEVEL_ERROR,
 		TRACE_REPORTING,
 		"FtsServiceInterrupts - Entry");
@@ -65,7 +65,7 @@ exit:
 
 	WdfWaitLockRelease(controller->ControllerLock);
 
-	Trace(
+	TraceHot(
 		TRACE_LEVEL_ERROR,
 		TRACE_REPORTING,
 		"FtsServiceInterrupts - Exit");
@@ -198,7 +198,7 @@ FtsBuildFunctionsTable(
 
 --*/
 {
-	UNREFERENCED_PARAMETER(SpbContext);
+	NTSTATUS status;
 
 	Trace(
 		TRACE_LEVEL_ERROR,
@@ -207,6 +207,16 @@ FtsBuildFunctionsTable(
 
 	ControllerContext->MaxFingers = 8;
 
+	status = FtsDetectChipFamily(ControllerContext, SpbContext);
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_INIT,
+			"FtsBuildFunctionsTable - Error detecting chip family - 0x%08lX",
+			status);
+	}
+
 	Trace(
 		TRACE_LEVEL_ERROR,
 		TRACE_REPORTING,
@@ -216,12 +226,101 @@ FtsBuildFunctionsTable(
 }
 
 NTSTATUS
-FtsConfigureInterruptEnable(
+FtsDetectChipFamily(
 	IN FTS_CONTROLLER_CONTEXT* ControllerContext,
 	IN SPB_CONTEXT* SpbContext
 )
+/*++
+
+  Routine Description:
+
+	Reads the chip ID registers to find out whether the controller is an
+	FTM3 or an FTM4, which place their interrupt enable register at
+	different addresses.
+
+  Arguments:
+
+	ControllerContext - A pointer to the current touch controller context
+	SpbContext - A pointer to the current i2c context
+
+  Return Value:
+
+	NTSTATUS indicating success or failure
+
+--*/
 {
 	NTSTATUS status;
+	BYTE ChipIdFTM3[2] = { CHIP_ID_ADDR_FTM3 };
+	BYTE ChipIdFTM4[2] = { CHIP_ID_ADDR_FTM4 };
+	BYTE ChipId[CHIP_ID_READ_SIZE] = { 0 };
+
+	Trace(
+		TRACE_LEVEL_ERROR,
+		TRACE_REPORTING,
+		"FtsDetectChipFamily - Entry");
+
+	ControllerContext->ChipFamily = FTS_CHIP_FAMILY_UNKNOWN;
+
+	status = SpbReadRegisterSynchronously(
+		SpbContext,
+		FTS_CMD_HW_REG_R,
+		ChipIdFTM4,
+		sizeof(ChipIdFTM4),
+		ChipId,
+		sizeof(ChipId));
+
+	if (NT_SUCCESS(status) &&
+		ChipId[1] == CHIP_ID_FTM4_0 &&
+		ChipId[2] == CHIP_ID_FTM4_1)
+	{
+		ControllerContext->ChipFamily = FTS_CHIP_FAMILY_FTM4;
+		goto exit;
+	}
+
+	status = SpbReadRegisterSynchronously(
+		SpbContext,
+		FTS_CMD_HW_REG_R,
+		ChipIdFTM3,
+		sizeof(ChipIdFTM3),
+		ChipId,
+		sizeof(ChipId));
+
+	if (NT_SUCCESS(status) &&
+		ChipId[1] == CHIP_ID_FTM3_0 &&
+		ChipId[2] == CHIP_ID_FTM3_1)
+	{
+		ControllerContext->ChipFamily = FTS_CHIP_FAMILY_FTM3;
+		goto exit;
+	}
+
+	Trace(
+		TRACE_LEVEL_ERROR,
+		TRACE_INIT,
+		"FtsDetectChipFamily - Unknown chip id %02X %02X - 0x%08lX",
+		ChipId[1],
+		ChipId[2],
+		status);
+
+	// Keep going with both register sets armed
+	status = STATUS_SUCCESS;
+
+exit:
+	Trace(
+		TRACE_LEVEL_ERROR,
+		TRACE_REPORTING,
+		"FtsDetectChipFamily - Exit - Family %d",
+		ControllerContext->ChipFamily);
+
+	return status;
+}
+
+NTSTATUS
+FtsConfigureInterruptEnable(
+	IN FTS_CONTROLLER_CONTEXT* ControllerContext,
+	IN SPB_CONTEXT* SpbContext
+)
+{
+	NTSTATUS status = STATUS_SUCCESS;
 
 	Trace(
 		TRACE_LEVEL_ERROR,
@@ -237,28 +336,37 @@ FtsConfigureInterruptEnable(
 	BYTE CommandFTM3[3] = { IER_ADDR_FTM3, IER_ENABLE };
 	BYTE CommandFTM4[3] = { IER_ADDR_FTM4, IER_ENABLE };
 
-	status = SpbWriteDataSynchronously(SpbContext, FTS_CMD_HW_REG_W, CommandFTM3, sizeof(CommandFTM3));
-	if (!NT_SUCCESS(status))
+	if (ControllerContext->ChipFamily != FTS_CHIP_FAMILY_FTM4)
 	{
-		Trace(
-			TRACE_LEVEL_ERROR,
-			TRACE_INTERRUPT,
-			"FtsConfigureInterruptEnable - Error enabling interrupts (FTM3) - 0x%08lX",
-			status);
-		goto exit;
+		status = SpbWriteDataSynchronously(SpbContext, FTS_CMD_HW_REG_W, CommandFTM3, sizeof(CommandFTM3));
+		if (!NT_SUCCESS(status))
+		{
+			Trace(
+				TRACE_LEVEL_ERROR,
+				TRACE_INTERRUPT,
+				"FtsConfigureInterruptEnable - Error enabling interrupts (FTM3) - 0x%08lX",
+				status);
+			goto exit;
+		}
 	}
 
-	status = SpbWriteDataSynchronously(SpbContext, FTS_CMD_HW_REG_W, CommandFTM4, sizeof(CommandFTM4));
-	if (!NT_SUCCESS(status))
+	if (ControllerContext->ChipFamily != FTS_CHIP_FAMILY_FTM3)
 	{
-		Trace(
-			TRACE_LEVEL_ERROR,
-			TRACE_INTERRUPT,
-			"FtsConfigureInterruptEnable - Error enabling interrupts (FTM4) - 0x%08lX",
-			status);
-		goto exit;
+		status = SpbWriteDataSynchronously(SpbContext, FTS_CMD_HW_REG_W, CommandFTM4, sizeof(CommandFTM4));
+		if (!NT_SUCCESS(status))
+		{
+			Trace(
+				TRACE_LEVEL_ERROR,
+				TRACE_INTERRUPT,
+				"FtsConfigureInterruptEnable - Error enabling interrupts (FTM4) - 0x%08lX",
+				status);
+			goto exit;
+		}
 	}
 
+	ControllerContext->InterruptEnablePending =
+		(ControllerContext->ChipFamily == FTS_CHIP_FAMILY_UNKNOWN);
+
 exit:
 	Trace(
 		TRACE_LEVEL_ERROR,
@@ -19,77 +19,58 @@
 --*/
 
 #include <Cross Platform Shim\compat.h>
-#include <spb.h>
+#include <spbhelper.h>
 #include <report.h>
 #include <fts\ftsinternal.h>
 #include <fts\ftsregs.h>
 #include <fts\ftsevents.h>
 #include <fts\ftspointer.h>
+#include <Cross Platform Shim\bitops.h>
 #include <ftspointer.tmh>
 
 NTSTATUS
-FtsProcessEnterPointerEvent(
+FtsFlushPointerReport(
 	FTS_CONTROLLER_CONTEXT* ControllerContext,
-	PREPORT_CONTEXT ReportContext,
-	BYTE* EventData
+	PREPORT_CONTEXT ReportContext
 )
-{
-	NTSTATUS status = STATUS_SUCCESS;
+/*++
 
-	int x, y;
-	BYTE X_MSB = 0;
-	BYTE X_LSB = 0;
-	BYTE Y_MSB = 0;
-	BYTE Y_LSB = 0;
+Routine Description:
 
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Enter Pointer");
+	Reports the current object state if any pointer event updated it
+	since the last report.
 
-	BYTE touchId = (EventData[2] & 0x0F);
+Arguments:
 
-	if (touchId >= MAX_TOUCHES || touchId < 0)
-	{
-		Trace(
-			TRACE_LEVEL_ERROR,
-			TRACE_REPORTING,
-			"FtsProcessOneEvent - Invalid touch id %d",
-			touchId);
-		goto exit;
-	}
+	ControllerContext - Touch controller context
+	ReportContext - Report context
 
-	X_MSB = EventData[3];
-	X_LSB = (EventData[5] & 0xF0) >> 4;
+Return Value:
 
-	Y_MSB = EventData[4];
-	Y_LSB = EventData[5] & 0x0F;
+	NTSTATUS indicating success or failure
 
-	x = (X_MSB << 4) | X_LSB;
-	y = (Y_MSB << 4) | Y_LSB;
+--*/
+{
+	NTSTATUS status = STATUS_SUCCESS;
 
-	ControllerContext->DetectedObjects.States[touchId] = OBJECT_STATE_FINGER_PRESENT_WITH_ACCURATE_POS;
-	ControllerContext->DetectedObjects.Positions[touchId].X = x;
-	ControllerContext->DetectedObjects.Positions[touchId].Y = y;
+	if (!ControllerContext->ReportPending)
+	{
+		goto exit;
+	}
 
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Touch %d at (x=%d, y=%d)",
-		touchId,
-		x,
-		y);
+	ControllerContext->ReportPending = FALSE;
+	ControllerContext->PendingPresenceMask = 0;
 
 	status = ReportObjects(
 		ReportContext,
-		ControllerContext->DetectedObjects);
+		&ControllerContext->DetectedObjects);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_VERBOSE,
 			TRACE_SAMPLES,
-			"FtsProcessOneEvent - Error while reporting objects - 0x%08lX",
+			"FtsFlushPointerReport - Error while reporting objects - 0x%08lX",
 			status);
 
 		goto exit;
@@ -97,169 +78,310 @@ FtsProcessEnterPointerEvent(
 
 exit:
 
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Exit - 0x%08lX",
-		status);
-
 	return status;
 }
 
-NTSTATUS
-FtsProcessMotionPointerEvent(
+static NTSTATUS
+FtsUpdatePointerObject(
 	FTS_CONTROLLER_CONTEXT* ControllerContext,
 	PREPORT_CONTEXT ReportContext,
-	BYTE* EventData
+	BYTE TouchId,
+	OBJECT_STATE State,
+	int X,
+	int Y,
+	UCHAR Pressure,
+	UCHAR Size
 )
+/*++
+
+Routine Description:
+
+	Applies a pointer event to the detected objects. In coalescing mode the
+	report is deferred until the whole FIFO batch has been applied, unless
+	the contact already appeared or disappeared earlier in the same batch,
+	in which case the pending state is reported first so that short taps
+	are not lost.
+
+Arguments:
+
+	ControllerContext - Touch controller context
+	ReportContext - Report context
+	TouchId - Contact slot the event applies to
+	State - New state of the contact
+	X, Y - New position of the contact
+	Pressure, Size - New pressure and size of the contact
+
+Return Value:
+
+	NTSTATUS indicating success or failure
+
+--*/
 {
 	NTSTATUS status = STATUS_SUCCESS;
+	BOOLEAN wasPresent;
+	BOOLEAN isPresent;
+
+	wasPresent = ControllerContext->DetectedObjects.States[TouchId] != OBJECT_STATE_NOT_PRESENT;
+	isPresent = State != OBJECT_STATE_NOT_PRESENT;
 
-	int x, y;
-	BYTE X_MSB = 0;
-	BYTE X_LSB = 0;
-	BYTE Y_MSB = 0;
-	BYTE Y_LSB = 0;
+	//
+	// Nothing to report for a contact that stays up, such as a hovering
+	// finger
+	//
+	if (!wasPresent && !isPresent)
+	{
+		goto exit;
+	}
 
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Motion Pointer");
+	if (ControllerContext->CoalesceReports &&
+		wasPresent != isPresent &&
+		(ControllerContext->PendingPresenceMask & (1UL << TouchId)) != 0)
+	{
+		status = FtsFlushPointerReport(ControllerContext, ReportContext);
+		if (!NT_SUCCESS(status))
+		{
+			goto exit;
+		}
+	}
 
-	BYTE touchId = (EventData[2] & 0x0F);
+	ControllerContext->DetectedObjects.States[TouchId] = State;
+	ControllerContext->DetectedObjects.Positions[TouchId].X = X;
+	ControllerContext->DetectedObjects.Positions[TouchId].Y = Y;
+	ControllerContext->DetectedObjects.Pressure[TouchId] = Pressure;
+	ControllerContext->DetectedObjects.Size[TouchId] = Size;
+	ControllerContext->DetectedObjects.DirtyMask |= 1UL << TouchId;
 
-	if (touchId >= MAX_TOUCHES || touchId < 0)
+	if (wasPresent != isPresent)
 	{
-		Trace(
-			TRACE_LEVEL_ERROR,
-			TRACE_REPORTING,
-			"FtsProcessOneEvent - Invalid touch id %d",
-			touchId);
-		goto exit;
+		ControllerContext->PendingPresenceMask |= 1UL << TouchId;
+		ControllerContext->DetectedObjects.PresentMask ^= 1UL << TouchId;
 	}
 
-	X_MSB = EventData[3];
-	X_LSB = (EventData[5] & 0xF0) >> 4;
+	ControllerContext->ReportPending = TRUE;
+
+	if (!ControllerContext->CoalesceReports)
+	{
+		status = FtsFlushPointerReport(ControllerContext, ReportContext);
+	}
+
+exit:
+
+	return status;
+}
 
-	Y_MSB = EventData[4];
-	Y_LSB = EventData[5] & 0x0F;
+//
+// Contact state after each pointer event, FTS_POINTER_STATE_NONE for
+// events that are not pointer events
+//
+#define FTS_POINTER_STATE_NONE 0
+#define FTS_POINTER_STATE(s) ((BYTE)((s) + 1))
 
-	x = (X_MSB << 4) | X_LSB;
-	y = (Y_MSB << 4) | Y_LSB;
+static const BYTE gFtsPointerEventStates[EVENTID_LAST] =
+{
+	[EVENTID_ENTER_POINTER] = FTS_POINTER_STATE(OBJECT_STATE_FINGER_PRESENT_WITH_ACCURATE_POS),
+	[EVENTID_MOTION_POINTER] = FTS_POINTER_STATE(OBJECT_STATE_FINGER_PRESENT_WITH_ACCURATE_POS),
+	[EVENTID_LEAVE_POINTER] = FTS_POINTER_STATE(OBJECT_STATE_NOT_PRESENT),
+
+	//
+	// A hovering finger is not a contact, it is kept out of the report
+	// until it lands and a finger lifting into hover is reported as up
+	//
+	[EVENTID_HOVER_ENTER_POINTER] = FTS_POINTER_STATE(OBJECT_STATE_NOT_PRESENT),
+	[EVENTID_HOVER_MOTION_POINTER] = FTS_POINTER_STATE(OBJECT_STATE_NOT_PRESENT),
+	[EVENTID_HOVER_LEAVE_POINTER] = FTS_POINTER_STATE(OBJECT_STATE_NOT_PRESENT),
+
+	[EVENTID_PEN_ENTER] = FTS_POINTER_STATE(OBJECT_STATE_PEN_PRESENT_WITH_TIP),
+	[EVENTID_PEN_MOTION] = FTS_POINTER_STATE(OBJECT_STATE_PEN_PRESENT_WITH_TIP),
+	[EVENTID_PEN_LEAVE] = FTS_POINTER_STATE(OBJECT_STATE_NOT_PRESENT),
+};
+
+VOID
+FtsDecodePointerEvents(
+	BYTE* EventData,
+	DWORD EventCount,
+	FTS_POINTER_BATCH* Batch
+)
+/*++
 
-	ControllerContext->DetectedObjects.States[touchId] = OBJECT_STATE_FINGER_PRESENT_WITH_ACCURATE_POS;
-	ControllerContext->DetectedObjects.Positions[touchId].X = x;
-	ControllerContext->DetectedObjects.Positions[touchId].Y = y;
+Routine Description:
 
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Touch %d at (x=%d, y=%d)",
-		touchId,
-		x,
-		y);
+	Decodes the pointer events of a FIFO batch in a single pass. Every
+	event is unpacked into the next batch entry, which is only kept when
+	the event is a pointer event, so the loop does not branch on the
+	event type. The other events are flagged in Batch->OtherEvents.
 
-	status = ReportObjects(
-		ReportContext,
-		ControllerContext->DetectedObjects);
+Arguments:
 
-	if (!NT_SUCCESS(status))
+	EventData - The FIFO events
+	EventCount - Number of events, at most FIFO_DEPTH
+	Batch - Receives the decoded pointer events
+
+Return Value:
+
+	None.
+
+--*/
+{
+	DWORD i;
+	DWORD n = 0;
+	BYTE* event;
+	BYTE state;
+
+	NT_ASSERT(EventCount <= FIFO_DEPTH);
+
+	RtlZeroMemory(Batch->OtherEvents, sizeof(Batch->OtherEvents));
+
+	for (i = 0; i < EventCount; i++)
 	{
-		Trace(
-			TRACE_LEVEL_VERBOSE,
-			TRACE_SAMPLES,
-			"FtsProcessOneEvent - Error while reporting objects - 0x%08lX",
-			status);
+		event = EventData + i * FIFO_EVENT_SIZE;
+		state = gFtsPointerEventStates[event[0]];
 
-		goto exit;
-	}
+		Batch->TouchId[n] = EVENT_TOUCH_ID(event);
+		Batch->State[n] = state - 1;
+		Batch->X[n] = (USHORT)EVENT_X(event);
+		Batch->Y[n] = (USHORT)EVENT_Y(event);
+		Batch->Pressure[n] = EVENT_PRESSURE(event);
+		Batch->Size[n] = EVENT_SIZE(event);
 
-exit:
+		n += (state != FTS_POINTER_STATE_NONE);
 
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Exit - 0x%08lX",
-		status);
+		Batch->OtherEvents[BIT_WORD(i)] |=
+			(unsigned long)(state == FTS_POINTER_STATE_NONE) << (i % BITS_PER_LONG);
+	}
 
-	return status;
+	Batch->Count = n;
 }
 
 NTSTATUS
-FtsProcessLeavePointerEvent(
+FtsApplyPointerEvents(
 	FTS_CONTROLLER_CONTEXT* ControllerContext,
 	PREPORT_CONTEXT ReportContext,
-	BYTE* EventData
+	FTS_POINTER_BATCH* Batch,
+	DWORD First,
+	DWORD Last
 )
-{
-	NTSTATUS status = STATUS_SUCCESS;
+/*++
+
+Routine Description:
+
+	Applies the decoded pointer events First to Last of a batch to the
+	detected objects, in the order the controller reported them.
+
+Arguments:
 
-	int x, y;
-	BYTE X_MSB = 0;
-	BYTE X_LSB = 0;
-	BYTE Y_MSB = 0;
-	BYTE Y_LSB = 0;
+	ControllerContext - Touch controller context
+	ReportContext - Report context
+	Batch - The decoded pointer events
+	First - Index of the first pointer event to apply
+	Last - Index past the last pointer event to apply
 
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Leave Pointer");
+Return Value:
+
+	NTSTATUS indicating success or failure
+
+--*/
+{
+	NTSTATUS status = STATUS_SUCCESS;
+	DWORD i;
 
-	BYTE touchId = (EventData[2] & 0x0F);
+	NT_ASSERT(First <= Last && Last <= Batch->Count);
 
-	if (touchId >= MAX_TOUCHES || touchId < 0)
+	for (i = First; i < Last; i++)
 	{
-		Trace(
+		TraceHot(
 			TRACE_LEVEL_ERROR,
 			TRACE_REPORTING,
-			"FtsProcessOneEvent - Invalid touch id %d",
-			touchId);
-		goto exit;
+			"FtsApplyPointerEvents - Touch %d at (x=%d, y=%d), state %d",
+			Batch->TouchId[i],
+			Batch->X[i],
+			Batch->Y[i],
+			Batch->State[i]);
+
+		status = FtsUpdatePointerObject(
+			ControllerContext,
+			ReportContext,
+			Batch->TouchId[i],
+			(OBJECT_STATE)Batch->State[i],
+			Batch->X[i],
+			Batch->Y[i],
+			Batch->Pressure[i],
+			Batch->Size[i]);
+
+		if (!NT_SUCCESS(status))
+		{
+			Trace(
+				TRACE_LEVEL_VERBOSE,
+				TRACE_SAMPLES,
+				"FtsApplyPointerEvents - Error while reporting objects - 0x%08lX",
+				status);
+
+			goto exit;
+		}
 	}
 
-	X_MSB = EventData[3];
-	X_LSB = (EventData[5] & 0xF0) >> 4;
+exit:
 
-	Y_MSB = EventData[4];
-	Y_LSB = EventData[5] & 0x0F;
+	return status;
+}
 
-	x = (X_MSB << 4) | X_LSB;
-	y = (Y_MSB << 4) | Y_LSB;
+NTSTATUS
+FtsLiftAllPointers(
+	FTS_CONTROLLER_CONTEXT* ControllerContext,
+	PREPORT_CONTEXT ReportContext
+)
+/*++
 
-	ControllerContext->DetectedObjects.States[touchId] = OBJECT_STATE_NOT_PRESENT;
-	ControllerContext->DetectedObjects.Positions[touchId].X = x;
-	ControllerContext->DetectedObjects.Positions[touchId].Y = y;
+Routine Description:
 
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Touch %d at (x=%d, y=%d) left",
-		touchId,
-		x,
-		y);
+	Reports every contact that is currently down as lifted. Used when
+	events were lost and the detected objects can no longer be trusted,
+	contacts still on the panel come back with their next event.
 
-	status = ReportObjects(
-		ReportContext,
-		ControllerContext->DetectedObjects);
+Arguments:
+
+	ControllerContext - Touch controller context
+	ReportContext - Report context
 
+Return Value:
+
+	NTSTATUS indicating success or failure
+
+--*/
+{
+	DETECTED_OBJECTS* objects = &ControllerContext->DetectedObjects;
+	NTSTATUS status;
+	unsigned long present;
+	unsigned long i;
+
+	//
+	// Report what was applied so far before lifting it
+	//
+	status = FtsFlushPointerReport(ControllerContext, ReportContext);
 	if (!NT_SUCCESS(status))
 	{
-		Trace(
-			TRACE_LEVEL_VERBOSE,
-			TRACE_SAMPLES,
-			"FtsProcessOneEvent - Error while reporting objects - 0x%08lX",
-			status);
+		goto exit;
+	}
+
+	present = objects->PresentMask;
 
+	if (present == 0)
+	{
 		goto exit;
 	}
 
-exit:
+	for_each_set_bit(i, &present, MAX_TOUCHES)
+	{
+		objects->States[i] = OBJECT_STATE_NOT_PRESENT;
+	}
+
+	objects->DirtyMask |= present;
+	objects->PresentMask = 0;
+
+	ControllerContext->ReportPending = TRUE;
 
-	Trace(
-		TRACE_LEVEL_ERROR,
-		TRACE_REPORTING,
-		"FtsProcessOneEvent - Exit - 0x%08lX",
-		status);
+	status = FtsFlushPointerReport(ControllerContext, ReportContext);
+
+exit:
 
 	return status;
-}
\ No newline at end of file
+}
@@ -36,23 +36,46 @@ const PWSTR gpwstrProductID = L"3708";
 const PWSTR gpwstrSerialNumber = L"4";
 
 //
-// HID Report Descriptor for a touch device
+// HID Report Descriptors for a touch device, one per supported number of
+// finger contacts per report
 //
 
-const UCHAR gReportDescriptor[] = {
-	ST_FTS_DIGITIZER_DIAGNOSTIC1,
-	ST_FTS_DIGITIZER_DIAGNOSTIC2,
-	ST_FTS_DIGITIZER_DIAGNOSTIC3,
-	ST_FTS_DIGITIZER_DIAGNOSTIC4,
-	ST_FTS_DIGITIZER_FINGER,
-	ST_FTS_DIGITIZER_REPORTMODE,
-	ST_FTS_DIGITIZER_KEYPAD,
-	ST_FTS_DIGITIZER_STYLUS
+const UCHAR gReportDescriptor2[] = {
+	ST_FTS_REPORT_DESCRIPTOR(ST_FTS_DIGITIZER_FINGER_CONTACTS_2)
+};
+
+#if TOUCH_MAX_CONTACTS_PER_REPORT >= 5
+const UCHAR gReportDescriptor5[] = {
+	ST_FTS_REPORT_DESCRIPTOR(ST_FTS_DIGITIZER_FINGER_CONTACTS_5)
+};
+#endif
+
+#if TOUCH_MAX_CONTACTS_PER_REPORT >= 10
+const UCHAR gReportDescriptor10[] = {
+	ST_FTS_REPORT_DESCRIPTOR(ST_FTS_DIGITIZER_FINGER_CONTACTS_10)
+};
+#endif
+
+typedef struct _TCH_REPORT_DESCRIPTOR_VARIANT
+{
+	ULONG ContactsPerReport;
+	const UCHAR* Descriptor;
+	ULONG Length;
+} TCH_REPORT_DESCRIPTOR_VARIANT;
+
+const TCH_REPORT_DESCRIPTOR_VARIANT gReportDescriptorVariants[] = {
+	{ 2, gReportDescriptor2, sizeof(gReportDescriptor2) },
+#if TOUCH_MAX_CONTACTS_PER_REPORT >= 5
+	{ 5, gReportDescriptor5, sizeof(gReportDescriptor5) },
+#endif
+#if TOUCH_MAX_CONTACTS_PER_REPORT >= 10
+	{ 10, gReportDescriptor10, sizeof(gReportDescriptor10) },
+#endif
 };
-const ULONG gdwcbReportDescriptor = sizeof(gReportDescriptor);
 
 //
-// HID Descriptor for a touch device
+// HID Descriptor for a touch device, wReportLength is patched with the
+// length of the report descriptor variant in use
 //
 const HID_DESCRIPTOR gHidDescriptor =
 {
@@ -63,34 +86,79 @@ const HID_DESCRIPTOR gHidDescriptor =
 	1,                                  //bNumDescriptors
 	{                                   //DescriptorList[0]
 		HID_REPORT_DESCRIPTOR_TYPE,     //bReportType
-		sizeof(gReportDescriptor)       //wReportLength
+		sizeof(gReportDescriptor2)      //wReportLength
 	}
 };
 
-NTSTATUS
-TchSendReport(
-	IN WDFQUEUE PingPongQueue,
-	IN PHID_INPUT_REPORT hidReportFromDriver
+static const TCH_REPORT_DESCRIPTOR_VARIANT*
+TchGetReportDescriptorVariant(
+	IN WDFDEVICE Device
 )
+/*++
+
+Routine Description:
+
+	Returns the report descriptor matching the number of finger contacts
+	per report selected in the screen properties.
+
+Arguments:
+
+	Device - Handle to WDF Device Object
+
+Return Value:
+
+	The report descriptor variant, the default one if the selection is
+	not supported
+
+--*/
 {
-	NTSTATUS status;
-	WDFREQUEST request;
-	PHID_INPUT_REPORT hidReportRequestBuffer;
-	size_t hidReportRequestBufferLength;
+	PDEVICE_EXTENSION devContext;
+	ULONG i;
 
-	Trace(
-		TRACE_LEVEL_INFORMATION,
-		TRACE_REPORTING,
-		"TchSendReport - Entry");
+	devContext = GetDeviceContext(Device);
 
-	status = STATUS_SUCCESS;
-	request = NULL;
+	for (i = 0; i < ARRAYSIZE(gReportDescriptorVariants); i++)
+	{
+		if (gReportDescriptorVariants[i].ContactsPerReport ==
+			devContext->ReportContext.Props.ContactsPerReport)
+		{
+			return &gReportDescriptorVariants[i];
+		}
+	}
+
+	return &gReportDescriptorVariants[0];
+}
+
+VOID
+TchTraceReport(
+	IN PHID_INPUT_REPORT hidReportFromDriver,
+	IN ULONG ContactsPerReport
+)
+/*++
+
+Routine Description:
+
+   Logs the contents of a HID input report.
+
+Arguments:
+
+   hidReportFromDriver - The report to log
+
+   ContactsPerReport - Finger contacts carried by a finger report
+
+Return Value:
+
+   None
+
+--*/
+{
+	TraceHotRing(TRACE_HOT_REPORT, hidReportFromDriver->ReportID);
 
 	switch (hidReportFromDriver->ReportID)
 	{
 	case REPORTID_STYLUS:
 	{
-		Trace(
+		TraceHot(
 			TRACE_LEVEL_INFORMATION,
 			TRACE_HID,
 			"HID pen: "
@@ -118,16 +186,16 @@ TchSendReport(
 	}
 	case REPORTID_FINGER:
 	{
-		Trace(
+		TraceHot(
 			TRACE_LEVEL_INFORMATION,
 			TRACE_HID,
 			"HID Finger: "
 			"Contact Count = %d",
-			hidReportFromDriver->TouchReport.ContactCount);
+			HID_TOUCH_REPORT_CONTACT_COUNT(&hidReportFromDriver->TouchReport, ContactsPerReport));
 
-		for (int i = 0; i < hidReportFromDriver->TouchReport.ContactCount; i++)
+		for (ULONG i = 0; i < ContactsPerReport; i++)
 		{
-			Trace(
+			TraceHot(
 				TRACE_LEVEL_INFORMATION,
 				TRACE_HID,
 				"Tip Switch = %d, "
@@ -147,7 +215,7 @@ TchSendReport(
 	}
 	case REPORTID_KEYPAD:
 	{
-		Trace(
+		TraceHot(
 			TRACE_LEVEL_INFORMATION,
 			TRACE_HID,
 			"HID key: "
@@ -161,31 +229,86 @@ TchSendReport(
 			hidReportFromDriver->KeyReport.ACBack);
 	}
 	}
+}
 
-	//
-	// Complete a HIDClass request if one is available
-	//
-	status = WdfIoQueueRetrieveNextRequest(
-		PingPongQueue,
-		&request);
+static ULONG
+TchGetInputReportLength(
+	IN ULONG ContactsPerReport
+)
+/*++
 
-	if (!NT_SUCCESS(status))
-	{
-		Trace(
-			TRACE_LEVEL_ERROR,
-			TRACE_REPORTING,
-			"No request pending from HIDClass, ignoring report - 0x%08lX",
-			status);
+Routine Description:
 
-		goto exit;
-	}
+   Returns the length of an input report as laid out by the finger report
+   variant in use. HID_INPUT_REPORT is sized for the largest variant, the
+   finger report of a smaller variant ends with its contact count.
+
+Arguments:
+
+   ContactsPerReport - Finger contacts carried by a finger report
+
+Return Value:
+
+   Length in bytes of the input reports of the variant
+
+--*/
+{
+	ULONG fingerLength;
+	ULONG penLength;
+	ULONG keyLength;
+
+	fingerLength = (ULONG)(FIELD_OFFSET(HID_INPUT_REPORT, TouchReport) +
+		ContactsPerReport * sizeof(HID_TOUCH_FINGER) + sizeof(UCHAR));
+	penLength = (ULONG)(FIELD_OFFSET(HID_INPUT_REPORT, PenReport) + sizeof(HID_PEN_REPORT));
+	keyLength = (ULONG)(FIELD_OFFSET(HID_INPUT_REPORT, KeyReport) + sizeof(HID_KEY_REPORT));
+
+	return max(fingerLength, max(penLength, keyLength));
+}
+
+NTSTATUS
+TchCompleteReadRequest(
+	IN WDFREQUEST request,
+	IN PHID_INPUT_REPORT hidReportFromDriver,
+	IN ULONG ContactsPerReport
+)
+/*++
+
+Routine Description:
+
+   Completes a HIDClass read request with a HID input report.
+
+Arguments:
+
+   request - The read request retrieved from the PingPongQueue
+
+   hidReportFromDriver - The report to return to HIDClass
+
+   ContactsPerReport - Finger contacts carried by a finger report
+
+Return Value:
+
+   NTSTATUS the request was completed with
+
+--*/
+{
+	NTSTATUS status;
+	PHID_INPUT_REPORT hidReportRequestBuffer;
+	size_t hidReportRequestBufferLength;
+	ULONG reportLength = TchGetInputReportLength(ContactsPerReport);
+
+	TraceHot(
+		TRACE_LEVEL_INFORMATION,
+		TRACE_REPORTING,
+		"TchCompleteReadRequest - Entry");
+
+	TchTraceReport(hidReportFromDriver, ContactsPerReport);
 
 	//
 	// Validate an output buffer was provided
 	//
 	status = WdfRequestRetrieveOutputBuffer(
 		request,
-		sizeof(HID_INPUT_REPORT),
+		reportLength,
 		&hidReportRequestBuffer,
 		&hidReportRequestBufferLength);
 
@@ -202,7 +325,7 @@ TchSendReport(
 		//
 		// Validate the size of the output buffer
 		//
-		if (hidReportRequestBufferLength < sizeof(HID_INPUT_REPORT))
+		if (hidReportRequestBufferLength < reportLength)
 		{
 			status = STATUS_BUFFER_TOO_SMALL;
 
@@ -218,20 +341,20 @@ TchSendReport(
 			RtlCopyMemory(
 				hidReportRequestBuffer,
 				hidReportFromDriver,
-				sizeof(HID_INPUT_REPORT));
+				reportLength);
 
-			WdfRequestSetInformation(request, sizeof(HID_INPUT_REPORT));
+			WdfRequestSetInformation(request, reportLength);
 		}
 	}
 
 	WdfRequestComplete(request, status);
 
-exit:
-	Trace(
+	TraceHot(
 		TRACE_LEVEL_INFORMATION,
 		TRACE_REPORTING,
-		"TchSendReport - Exit - 0x%08lX",
+		"TchCompleteReadRequest - Exit - 0x%08lX",
 		status);
+
 	return status;
 }
 
@@ -292,6 +415,11 @@ Return Value:
 		*Pending = TRUE;
 	}
 
+	//
+	// Hand out any reports that were buffered while no read was pending
+	//
+	ReportDrainRing(&devContext->ReportContext);
+
 	//
 	// Service any interrupt that may have asserted while the framework had
 	// interrupts disabled, or occurred before a read request was queued.
@@ -442,6 +570,7 @@ TchGenerateHidReportDescriptor(
 {
 	PDEVICE_EXTENSION devContext;
 	FTS_CONTROLLER_CONTEXT* touchContext;
+	const TCH_REPORT_DESCRIPTOR_VARIANT* variant;
 	NTSTATUS status;
 
 	Trace(
@@ -450,12 +579,13 @@ TchGenerateHidReportDescriptor(
 		"TchGenerateHidReportDescriptor - Entry");
 
 	devContext = GetDeviceContext(Device);
+	variant = TchGetReportDescriptorVariant(Device);
 
 	touchContext = (FTS_CONTROLLER_CONTEXT*)devContext->TouchContext;
 
 	PUCHAR hidReportDescBuffer = (PUCHAR)ExAllocatePoolWithTag(
 		NonPagedPool,
-		gdwcbReportDescriptor,
+		variant->Length,
 		TOUCH_POOL_TAG
 	);
 
@@ -472,11 +602,11 @@ TchGenerateHidReportDescriptor(
 
 	RtlCopyBytes(
 		hidReportDescBuffer,
-		gReportDescriptor,
-		gdwcbReportDescriptor
+		variant->Descriptor,
+		variant->Length
 	);
 
-	for (unsigned int i = 0; i < gdwcbReportDescriptor - 2; i++)
+	for (unsigned int i = 0; i < variant->Length - 2; i++)
 	{
 		if (*(hidReportDescBuffer + i) == LOGICAL_MAXIMUM_2)
 		{
@@ -517,7 +647,7 @@ TchGenerateHidReportDescriptor(
 		Memory,
 		0,
 		(PVOID)hidReportDescBuffer,
-		gdwcbReportDescriptor);
+		variant->Length);
 
 	if (!NT_SUCCESS(status))
 	{
@@ -566,10 +696,9 @@ Return Value:
 --*/
 {
 	WDFMEMORY memory;
+	HID_DESCRIPTOR hidDescriptor;
 	NTSTATUS status;
 
-	UNREFERENCED_PARAMETER(Device);
-
 	Trace(
 		TRACE_LEVEL_INFORMATION,
 		TRACE_REPORTING,
@@ -597,13 +726,18 @@ Return Value:
 	}
 
 	//
-	// Use hardcoded global HID Descriptor
+	// Use hardcoded global HID Descriptor, pointing to the report
+	// descriptor variant in use
 	//
+	RtlCopyMemory(&hidDescriptor, &gHidDescriptor, sizeof(hidDescriptor));
+	hidDescriptor.DescriptorList[0].wReportLength =
+		(USHORT)TchGetReportDescriptorVariant(Device)->Length;
+
 	status = WdfMemoryCopyFromBuffer(
 		memory,
 		0,
-		(PUCHAR)&gHidDescriptor,
-		sizeof(gHidDescriptor));
+		(PUCHAR)&hidDescriptor,
+		sizeof(hidDescriptor));
 
 	if (!NT_SUCCESS(status))
 	{
@@ -708,7 +842,7 @@ Return Value:
 	//
 	// Report how many bytes were copied
 	//
-	WdfRequestSetInformation(Request, gdwcbReportDescriptor);
+	WdfRequestSetInformation(Request, TchGetReportDescriptorVariant(Device)->Length);
 
 exit:
 
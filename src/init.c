@@ -20,10 +20,97 @@
 --*/
 
 #include <Cross Platform Shim\compat.h>
-#include <spb.h>
+#include <spbhelper.h>
 #include <fts\ftsinternal.h>
 #include <init.tmh>
 
+NTSTATUS
+TchWaitForControllerReady(
+	IN SPB_CONTEXT* SpbContext,
+	IN ULONG Timeout
+)
+/*++
+
+  Routine Description:
+
+	Waits for the controller to boot after a reset by polling the FIFO
+	for the controller ready event. The poll interval starts short and
+	doubles up to FTS_READY_POLL_MAX_INTERVAL, so a fast boot is seen
+	early without keeping the bus busy during a slow one. Reads failing
+	while the controller boots are expected and only mean it is not
+	ready yet.
+
+  Arguments:
+
+	SpbContext - A pointer to the current i2c context
+
+	Timeout - Upper bound of the wait, in microseconds
+
+  Return Value:
+
+	STATUS_SUCCESS once the controller is ready, STATUS_IO_TIMEOUT if
+	it did not report ready in time
+
+--*/
+{
+	BYTE event[FIFO_EVENT_SIZE];
+	LARGE_INTEGER delay;
+	ULONG64 deadline;
+	ULONG64 start;
+	ULONG64 now;
+	ULONG interval;
+	ULONG polls;
+	NTSTATUS status;
+
+	start = KeQueryInterruptTime();
+	deadline = start + (ULONG64)Timeout * 10;
+	interval = FTS_READY_POLL_MIN_INTERVAL;
+	polls = 0;
+
+	for (;;)
+	{
+		polls++;
+
+		status = SpbReadDataSynchronously(
+			SpbContext,
+			FIFO_CMD_READONE,
+			event,
+			sizeof(event));
+
+		if (NT_SUCCESS(status) && event[0] == EVENTID_CONTROLLER_READY)
+		{
+			status = STATUS_SUCCESS;
+			break;
+		}
+
+		now = KeQueryInterruptTime();
+
+		if (now >= deadline)
+		{
+			status = STATUS_IO_TIMEOUT;
+			break;
+		}
+
+		//
+		// Do not sleep past the deadline, the last poll happens there
+		//
+		delay.QuadPart = -(LONGLONG)min((ULONG64)interval * 10, deadline - now);
+		KeDelayExecutionThread(KernelMode, TRUE, &delay);
+
+		interval = min(interval * 2, FTS_READY_POLL_MAX_INTERVAL);
+	}
+
+	Trace(
+		TRACE_LEVEL_INFORMATION,
+		TRACE_INIT,
+		"TchWaitForControllerReady - 0x%08lX after %llu us and %d polls",
+		status,
+		(KeQueryInterruptTime() - start) / 10,
+		polls);
+
+	return status;
+}
+
 NTSTATUS
 TchStartDevice(
 	IN VOID* ControllerContext,
@@ -245,6 +332,8 @@ Return Value:
 
 	RtlZeroMemory(context, sizeof(FTS_CONTROLLER_CONTEXT));
 	context->FxDevice = FxDevice;
+	context->FifoSpeculativeEvents = FTS_DEFAULT_FIFO_SPECULATIVE_EVENTS;
+	context->CoalesceReports = FTS_DEFAULT_COALESCE_REPORTS;
 
 	//
 	// Get Touch settings and populate context
@@ -0,0 +1,237 @@
+/*++
+	Copyright (c) LumiaWoA authors. All Rights Reserved.
+
+	Module Name:
+
+		latency.c
+
+	Abstract:
+
+		Records the time spent between the entry of the interrupt service
+		routine and the stages of the report pipeline into per-device
+		histograms
+
+	Environment:
+
+		Kernel mode
+
+	Revision History:
+
+--*/
+
+#include <Cross Platform Shim\compat.h>
+#include <latency.h>
+
+static ULONG64
+LatencyNow(
+	VOID
+)
+{
+	ULONG64 qpc;
+
+	return KeQueryInterruptTimePrecise(&qpc);
+}
+
+VOID
+LatencyStartFrame(
+	IN LATENCY_CONTEXT* Latency
+)
+/*++
+
+Routine Description:
+
+	Marks the entry of the interrupt service routine, the following
+	stages of the frame are measured from this point. Must be called on
+	the thread servicing the interrupt.
+
+Arguments:
+
+	Latency - Latency context of the device
+
+Return Value:
+
+	None.
+
+--*/
+{
+	Latency->FrameThread = KeGetCurrentThread();
+	InterlockedExchange64(&Latency->FrameStart, (LONG64)LatencyNow());
+}
+
+VOID
+LatencyEndFrame(
+	IN LATENCY_CONTEXT* Latency
+)
+/*++
+
+Routine Description:
+
+	Marks the exit of the interrupt service routine, stages recorded
+	outside of a frame are ignored
+
+Arguments:
+
+	Latency - Latency context of the device
+
+Return Value:
+
+	None.
+
+--*/
+{
+	InterlockedExchange64(&Latency->FrameStart, 0);
+	Latency->FrameThread = NULL;
+}
+
+ULONG64
+LatencyFrameStart(
+	IN LATENCY_CONTEXT* Latency
+)
+/*++
+
+Routine Description:
+
+	Returns the start of the current frame so that a stage completing
+	after the frame, such as the completion of a buffered report, can be
+	recorded later with LatencyRecordSince. Only the thread servicing the
+	interrupt, running at PASSIVE_LEVEL, is inside the frame.
+
+Arguments:
+
+	Latency - Latency context of the device
+
+Return Value:
+
+	Interrupt time of the ISR entry, zero outside of a frame or when
+	called from another path
+
+--*/
+{
+	//
+	// The ISR runs at PASSIVE_LEVEL, a DPC may interrupt its thread and
+	// must not be mistaken for it
+	//
+	if (KeGetCurrentIrql() != PASSIVE_LEVEL ||
+		Latency->FrameThread != KeGetCurrentThread())
+	{
+		return 0;
+	}
+
+	return (ULONG64)ReadNoFence64(&Latency->FrameStart);
+}
+
+VOID
+LatencyRecordSince(
+	IN LATENCY_CONTEXT* Latency,
+	IN LATENCY_STAGE Stage,
+	IN ULONG64 Start
+)
+/*++
+
+Routine Description:
+
+	Counts the time elapsed since Start in the histogram of a stage
+
+Arguments:
+
+	Latency - Latency context of the device
+	Stage - The stage that just completed
+	Start - Interrupt time the stage is measured from, zero to skip
+
+Return Value:
+
+	None.
+
+--*/
+{
+	ULONG64 elapsed;
+	ULONG micros;
+	ULONG bucket;
+
+	if (Start == 0)
+	{
+		return;
+	}
+
+	//
+	// Interrupt time is in 100ns units
+	//
+	elapsed = (LatencyNow() - Start) / 10;
+	micros = elapsed > MAXULONG ? MAXULONG : (ULONG)elapsed;
+
+	if (_BitScanReverse(&bucket, micros))
+	{
+		bucket = min(bucket + 1, LATENCY_HISTOGRAM_BUCKETS - 1);
+	}
+	else
+	{
+		bucket = 0;
+	}
+
+	InterlockedIncrement(&Latency->Buckets[Stage][bucket]);
+}
+
+VOID
+LatencyRecord(
+	IN LATENCY_CONTEXT* Latency,
+	IN LATENCY_STAGE Stage
+)
+/*++
+
+Routine Description:
+
+	Counts the time elapsed since the start of the current frame in the
+	histogram of a stage
+
+Arguments:
+
+	Latency - Latency context of the device
+	Stage - The stage that just completed
+
+Return Value:
+
+	None.
+
+--*/
+{
+	LatencyRecordSince(Latency, Stage, LatencyFrameStart(Latency));
+}
+
+VOID
+LatencyReadHistogram(
+	IN LATENCY_CONTEXT* Latency,
+	OUT ULONG* Counts,
+	IN BOOLEAN Reset
+)
+/*++
+
+Routine Description:
+
+	Copies the histograms of all stages, optionally clearing them
+
+Arguments:
+
+	Latency - Latency context of the device
+	Counts - Receives LATENCY_STAGE_COUNT * LATENCY_HISTOGRAM_BUCKETS
+		counts, stage by stage
+	Reset - TRUE to clear the histograms
+
+Return Value:
+
+	None.
+
+--*/
+{
+	ULONG stage;
+	ULONG bucket;
+
+	for (stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+	{
+		for (bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++)
+		{
+			*Counts++ = Reset ?
+				(ULONG)InterlockedExchange(&Latency->Buckets[stage][bucket], 0) :
+				(ULONG)ReadNoFence(&Latency->Buckets[stage][bucket]);
+		}
+	}
+}
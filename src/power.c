@@ -21,12 +21,382 @@
 
 #include <Cross Platform Shim\compat.h>
 #include <controller.h>
-#include <spb.h>
+#include <spbhelper.h>
 #include <fts\ftsinternal.h>
 #include <internal.h>
 #include <touch_power\touch_power.h>
 #include <power.tmh>
 
+#define WAKEUP_GESTURE_KEY_PATH L"\\Registry\\Machine\\SOFTWARE\\OEM\\Nokia\\Touch\\WakeupGesture"
+
+static VOID
+TchReadWakeupGestureSetting(
+	IN PDEVICE_EXTENSION DeviceContext
+)
+/*++
+
+Routine Description:
+
+	Refreshes the cached WakeupGesture setting from the registry
+
+Arguments:
+
+	DeviceContext - Device context holding the cache
+
+Return Value:
+
+	None
+
+--*/
+{
+	DWORD gestureEnabled = 0;
+
+	if (!NT_SUCCESS(RtlReadRegistryValue(
+		(PCWSTR)WAKEUP_GESTURE_KEY_PATH,
+		(PCWSTR)L"Enabled",
+		REG_DWORD,
+		&gestureEnabled,
+		sizeof(DWORD))))
+	{
+		gestureEnabled = 0;
+	}
+
+	InterlockedExchange(&DeviceContext->WakeupGestureEnabled, gestureEnabled == 1);
+
+	Trace(
+		TRACE_LEVEL_INFORMATION,
+		TRACE_POWER,
+		"Wakeup gesture %s",
+		gestureEnabled == 1 ? "enabled" : "disabled");
+}
+
+static NTSTATUS
+TchArmWakeupGestureNotification(
+	IN PDEVICE_EXTENSION DeviceContext
+)
+/*++
+
+Routine Description:
+
+	Asks for the wakeup gesture notify routine to be queued on the next
+	change of the WakeupGesture key. Called with WakeupGestureLock held so
+	that the key cannot be closed meanwhile.
+
+Arguments:
+
+	DeviceContext - Device context holding the cache
+
+Return Value:
+
+	NTSTATUS, STATUS_PENDING once the notification is armed
+
+--*/
+{
+	return ZwNotifyChangeKey(
+		DeviceContext->WakeupGestureKey,
+		NULL,
+		(PIO_APC_ROUTINE)&DeviceContext->WakeupGestureNotifyItem,
+		(PVOID)(UINT_PTR)DelayedWorkQueue,
+		&DeviceContext->WakeupGestureIoStatus,
+		REG_NOTIFY_CHANGE_LAST_SET,
+		FALSE,
+		NULL,
+		0,
+		TRUE);
+}
+
+static VOID
+TchWakeupGestureNotifyRoutine(
+	IN PVOID Context
+)
+/*++
+
+Routine Description:
+
+	Completion of a WakeupGesture key notification. Kernel mode key
+	notifications can only complete to an executive work item, which holds
+	no reference on the device, so the work is handed over to the device's
+	WDF work item right away.
+
+Arguments:
+
+	Context - Device context holding the cache
+
+Return Value:
+
+	None
+
+--*/
+{
+	PDEVICE_EXTENSION devContext = (PDEVICE_EXTENSION)Context;
+
+	WdfWorkItemEnqueue(devContext->WakeupGestureWorkItem);
+}
+
+VOID
+TchWakeupGestureWorkItem(
+	IN WDFWORKITEM WorkItem
+)
+/*++
+
+Routine Description:
+
+	Runs when the WakeupGesture key changed or was closed. Refreshes the
+	cache and re-arms the notification, or signals that no notification
+	is pending any more.
+
+Arguments:
+
+	WorkItem - The wakeup gesture work item, parented to the device
+
+Return Value:
+
+	None
+
+--*/
+{
+	PDEVICE_EXTENSION devContext = GetDeviceContext(WdfWorkItemGetParentObject(WorkItem));
+	NTSTATUS status;
+	BOOLEAN armed = FALSE;
+
+	if (devContext->WakeupGestureIoStatus.Status != STATUS_NOTIFY_CLEANUP)
+	{
+		TchReadWakeupGestureSetting(devContext);
+	}
+
+	//
+	// The key is closed under the same lock once stopping, a notification
+	// is never armed on a closed handle
+	//
+	WdfWaitLockAcquire(devContext->WakeupGestureLock, NULL);
+
+	if (!devContext->WakeupGestureStopping &&
+		devContext->WakeupGestureIoStatus.Status != STATUS_NOTIFY_CLEANUP)
+	{
+		status = TchArmWakeupGestureNotification(devContext);
+		if (NT_SUCCESS(status))
+		{
+			armed = TRUE;
+		}
+		else
+		{
+			Trace(
+				TRACE_LEVEL_ERROR,
+				TRACE_POWER,
+				"Error re-arming wakeup gesture notification - 0x%08lX",
+				status);
+		}
+	}
+
+	if (!armed)
+	{
+		KeSetEvent(&devContext->WakeupGestureNotifyIdle, IO_NO_INCREMENT, FALSE);
+	}
+
+	WdfWaitLockRelease(devContext->WakeupGestureLock);
+}
+
+NTSTATUS
+TchWakeupGestureCacheInitialize(
+	IN PDEVICE_EXTENSION DeviceContext
+)
+/*++
+
+Routine Description:
+
+	Reads the WakeupGesture setting and watches its registry key so the
+	display off path never has to access the registry
+
+Arguments:
+
+	DeviceContext - Device context holding the cache
+
+Return Value:
+
+	NTSTATUS indicating success or failure, a missing key only leaves
+	the wakeup gesture disabled
+
+--*/
+{
+	UNICODE_STRING keyName;
+	OBJECT_ATTRIBUTES attributes;
+	WDF_OBJECT_ATTRIBUTES objectAttributes;
+	WDF_WORKITEM_CONFIG workItemConfig;
+	NTSTATUS status;
+
+	DeviceContext->WakeupGestureKey = NULL;
+	DeviceContext->WakeupGestureWorkItem = NULL;
+	DeviceContext->WakeupGestureLock = NULL;
+	DeviceContext->WakeupGestureStopping = FALSE;
+
+	KeInitializeEvent(&DeviceContext->WakeupGestureNotifyIdle, NotificationEvent, TRUE);
+	ExInitializeWorkItem(&DeviceContext->WakeupGestureNotifyItem, TchWakeupGestureNotifyRoutine, DeviceContext);
+
+	TchReadWakeupGestureSetting(DeviceContext);
+
+	RtlInitUnicodeString(&keyName, WAKEUP_GESTURE_KEY_PATH);
+
+	InitializeObjectAttributes(
+		&attributes,
+		&keyName,
+		OBJ_CASE_INSENSITIVE | OBJ_KERNEL_HANDLE,
+		NULL,
+		NULL);
+
+	status = ZwOpenKey(
+		&DeviceContext->WakeupGestureKey,
+		KEY_NOTIFY,
+		&attributes);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_INFORMATION,
+			TRACE_POWER,
+			"No wakeup gesture key to watch - 0x%08lX",
+			status);
+
+		DeviceContext->WakeupGestureKey = NULL;
+		status = STATUS_SUCCESS;
+		goto exit;
+	}
+
+	WDF_OBJECT_ATTRIBUTES_INIT(&objectAttributes);
+	objectAttributes.ParentObject = DeviceContext->FxDevice;
+
+	status = WdfWaitLockCreate(
+		&objectAttributes,
+		&DeviceContext->WakeupGestureLock);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_POWER,
+			"Error creating wakeup gesture lock - 0x%08lX",
+			status);
+
+		goto cleanup;
+	}
+
+	//
+	// The WDF work item keeps the device referenced while it runs, it is
+	// parented to the device so it cannot outlive it
+	//
+	WDF_WORKITEM_CONFIG_INIT(&workItemConfig, TchWakeupGestureWorkItem);
+
+	status = WdfWorkItemCreate(
+		&workItemConfig,
+		&objectAttributes,
+		&DeviceContext->WakeupGestureWorkItem);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_POWER,
+			"Error creating wakeup gesture work item - 0x%08lX",
+			status);
+
+		goto cleanup;
+	}
+
+	KeClearEvent(&DeviceContext->WakeupGestureNotifyIdle);
+
+	WdfWaitLockAcquire(DeviceContext->WakeupGestureLock, NULL);
+	status = TchArmWakeupGestureNotification(DeviceContext);
+	WdfWaitLockRelease(DeviceContext->WakeupGestureLock);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_POWER,
+			"Error arming wakeup gesture notification - 0x%08lX",
+			status);
+
+		KeSetEvent(&DeviceContext->WakeupGestureNotifyIdle, IO_NO_INCREMENT, FALSE);
+		goto cleanup;
+	}
+
+	status = STATUS_SUCCESS;
+	goto exit;
+
+cleanup:
+
+	if (DeviceContext->WakeupGestureWorkItem != NULL)
+	{
+		WdfObjectDelete(DeviceContext->WakeupGestureWorkItem);
+		DeviceContext->WakeupGestureWorkItem = NULL;
+	}
+
+	if (DeviceContext->WakeupGestureLock != NULL)
+	{
+		WdfObjectDelete(DeviceContext->WakeupGestureLock);
+		DeviceContext->WakeupGestureLock = NULL;
+	}
+
+	ZwClose(DeviceContext->WakeupGestureKey);
+	DeviceContext->WakeupGestureKey = NULL;
+
+exit:
+
+	return status;
+}
+
+VOID
+TchWakeupGestureCacheDeinitialize(
+	IN PDEVICE_EXTENSION DeviceContext
+)
+/*++
+
+Routine Description:
+
+	Stops watching the WakeupGesture key. Re-arming is stopped and the key
+	closed under the wakeup gesture lock, closing the key completes the
+	pending notification. Waits for the work item to see it and to
+	return before deleting it.
+
+Arguments:
+
+	DeviceContext - Device context holding the cache
+
+Return Value:
+
+	None
+
+--*/
+{
+	if (DeviceContext->WakeupGestureKey == NULL)
+	{
+		return;
+	}
+
+	WdfWaitLockAcquire(DeviceContext->WakeupGestureLock, NULL);
+
+	DeviceContext->WakeupGestureStopping = TRUE;
+
+	ZwClose(DeviceContext->WakeupGestureKey);
+	DeviceContext->WakeupGestureKey = NULL;
+
+	WdfWaitLockRelease(DeviceContext->WakeupGestureLock);
+
+	KeWaitForSingleObject(
+		&DeviceContext->WakeupGestureNotifyIdle,
+		Executive,
+		KernelMode,
+		FALSE,
+		NULL);
+
+	WdfWorkItemFlush(DeviceContext->WakeupGestureWorkItem);
+
+	WdfObjectDelete(DeviceContext->WakeupGestureWorkItem);
+	DeviceContext->WakeupGestureWorkItem = NULL;
+
+	WdfObjectDelete(DeviceContext->WakeupGestureLock);
+	DeviceContext->WakeupGestureLock = NULL;
+}
+
 NTSTATUS
 TchPowerSettingCallback(
 	_In_ LPCGUID SettingGuid,
@@ -161,7 +531,6 @@ TchPowerSettingCallback(
 		}
 
 		DWORD DisplayState = *(DWORD*)Value;
-		DWORD GestureEnabled = 0;
 
 		switch (DisplayState)
 		{
@@ -183,12 +552,7 @@ TchPowerSettingCallback(
 				goto exit;
 			}
 
-			if (NT_SUCCESS(RtlReadRegistryValue(
-				(PCWSTR)L"\\Registry\\Machine\\SOFTWARE\\OEM\\Nokia\\Touch\\WakeupGesture",
-				(PCWSTR)L"Enabled",
-				REG_DWORD,
-				&GestureEnabled,
-				sizeof(DWORD))) && GestureEnabled == 1)
+			if (ReadNoFence(&devContext->WakeupGestureEnabled) != 0)
 			{
 				status = FtsSetReportingFlags(
 					ControllerContext,
@@ -412,14 +776,19 @@ Return Value:
 	controller->DevicePowerState = PowerDeviceD3;
 
 	//
-	// Invalidate state
+	// Invalidate state, the re-report timer reads the cache as well
 	//
+	WdfSpinLockAcquire(((PREPORT_CONTEXT)ReportContext)->ReReportLock);
 	((PREPORT_CONTEXT)ReportContext)->Cache.SlotValid = 0;
 	((PREPORT_CONTEXT)ReportContext)->Cache.SlotDirty = 0;
+	((PREPORT_CONTEXT)ReportContext)->Cache.PenSlots = 0;
 	((PREPORT_CONTEXT)ReportContext)->Cache.DownCount = 0;
+	WdfSpinLockRelease(((PREPORT_CONTEXT)ReportContext)->ReReportLock);
 	((PREPORT_CONTEXT)ReportContext)->ButtonCache.ButtonSlots[0] = 0;
 	((PREPORT_CONTEXT)ReportContext)->ButtonCache.ButtonSlots[1] = 0;
 	((PREPORT_CONTEXT)ReportContext)->ButtonCache.ButtonSlots[2] = 0;
+	controller->ReportPending = FALSE;
+	controller->PendingPresenceMask = 0;
 
 
 	WdfWaitLockRelease(controller->ControllerLock);
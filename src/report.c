@@ -24,13 +24,203 @@
 #include <resolutions.h>
 #include <hid.h>
 #include <HidCommon.h>
-#include <spb.h>
+#include <spbhelper.h>
 #include <report.h>
+#include <Cross Platform Shim\bitops.h>
 #include <report.tmh>
 
-WDFTIMER  timerHandle;
-PREPORT_CONTEXT cachedReportContext = NULL;
-DETECTED_OBJECTS objectData;
+//
+// The re-report timer finds the report context of its device through
+// its object context
+//
+typedef struct _REPORT_TIMER_CONTEXT
+{
+	PREPORT_CONTEXT ReportContext;
+} REPORT_TIMER_CONTEXT;
+
+WDF_DECLARE_CONTEXT_TYPE_WITH_NAME(REPORT_TIMER_CONTEXT, GetReportTimerContext)
+
+VOID
+ReportDrainRing(
+	IN PREPORT_CONTEXT ReportContext
+)
+/*++
+
+Routine Description:
+
+	Completes pending HIDClass read requests with buffered reports, in
+	the order the reports were produced. Callers racing with an ongoing
+	drain only flag that another pass is needed, so at most one caller
+	consumes the ring at any time.
+
+Arguments:
+
+	ReportContext - Report context holding the ring
+
+Return Value:
+
+	None.
+
+--*/
+{
+	REPORT_RING* ring = &ReportContext->Ring;
+	REPORT_RING_ENTRY entry;
+	WDFREQUEST request;
+	NTSTATUS status;
+	LONG tail;
+
+	if (InterlockedIncrement(&ring->DrainRequests) != 1)
+	{
+		return;
+	}
+
+	do
+	{
+		InterlockedExchange(&ring->DrainRequests, 1);
+
+		while ((tail = ReadAcquire(&ring->Tail)) != ReadAcquire(&ring->Head))
+		{
+			status = WdfIoQueueRetrieveNextRequest(
+				ReportContext->PingPongQueue,
+				&request);
+
+			if (!NT_SUCCESS(status))
+			{
+				break;
+			}
+
+			//
+			// A producer may drop the oldest entry when the ring is full,
+			// only use the copy if the tail did not move meanwhile. The ring
+			// cannot run empty underneath us as a drop is always followed
+			// by a new entry.
+			//
+			for (;;)
+			{
+				RtlCopyMemory(&entry, &ring->Entries[tail & (REPORT_RING_SIZE - 1)], sizeof(entry));
+
+				if (InterlockedCompareExchange(&ring->Tail, tail + 1, tail) == tail)
+				{
+					break;
+				}
+
+				tail = ReadAcquire(&ring->Tail);
+			}
+
+			TchCompleteReadRequest(
+				request,
+				&entry.Report,
+				ReportContext->Props.ContactsPerReport);
+
+			LatencyRecordSince(
+				&ReportContext->Latency,
+				LATENCY_STAGE_REPORT_COMPLETED,
+				entry.FrameStart);
+		}
+	} while (InterlockedCompareExchange(&ring->DrainRequests, 0, 1) != 1);
+}
+
+NTSTATUS
+ReportSendHidReport(
+	IN PREPORT_CONTEXT ReportContext,
+	IN PHID_INPUT_REPORT HidReport,
+	IN BOOLEAN Droppable,
+	IN ULONG64 FrameStart
+)
+/*++
+
+Routine Description:
+
+	Queues a HID input report for HIDClass and completes as many pending
+	read requests as possible. Reports that arrive while no read request
+	is pending stay buffered until TchReadReport provides one.
+
+	When the ring is full, the overflow policy decides which report to
+	lose. Droppable reports (motion) only use the ring up to the reserve,
+	the others (lift-offs, keys) may use the reserve as well.
+
+Arguments:
+
+	ReportContext - Report context holding the ring
+	HidReport - The report to send
+	Droppable - TRUE if the report only carries motion and may be dropped
+	FrameStart - Start of the frame the report belongs to, taken by the
+		interrupt thread with LatencyFrameStart, zero if not measured
+
+Return Value:
+
+	NTSTATUS, reports lost to the overflow policy are only counted
+
+--*/
+{
+	REPORT_RING* ring = &ReportContext->Ring;
+	NTSTATUS status = STATUS_SUCCESS;
+	LONG head;
+	LONG tail;
+	LONG limit = Droppable ? REPORT_RING_SIZE - REPORT_RING_RESERVE : REPORT_RING_SIZE;
+
+	//
+	// Reports are produced by the interrupt path and by the re-report
+	// timer, the push lock keeps them from claiming the same slot
+	//
+	WdfSpinLockAcquire(ring->PushLock);
+
+	head = ring->Head;
+	tail = ReadAcquire(&ring->Tail);
+
+	if (head - tail >= limit)
+	{
+		if (ring->OverflowPolicy == REPORT_RING_DROP_OLDEST_MOTION &&
+			ring->Entries[tail & (REPORT_RING_SIZE - 1)].Droppable &&
+			InterlockedCompareExchange(&ring->Tail, tail + 1, tail) == tail)
+		{
+			ring->DroppedReports++;
+		}
+		else if (head - ReadAcquire(&ring->Tail) >= limit)
+		{
+			if (Droppable)
+			{
+				ring->DroppedReports++;
+			}
+			else
+			{
+				ring->LostLiftOffs++;
+			}
+
+			Trace(
+				TRACE_LEVEL_ERROR,
+				TRACE_REPORTING,
+				"Report ring full, dropping report - %d dropped, %d lift-offs lost",
+				ring->DroppedReports,
+				ring->LostLiftOffs);
+
+			goto unlock;
+		}
+	}
+
+	RtlCopyMemory(
+		&ring->Entries[head & (REPORT_RING_SIZE - 1)].Report,
+		HidReport,
+		sizeof(HID_INPUT_REPORT));
+
+	ring->Entries[head & (REPORT_RING_SIZE - 1)].Timestamp = KeQueryInterruptTime();
+	ring->Entries[head & (REPORT_RING_SIZE - 1)].FrameStart = FrameStart;
+	ring->Entries[head & (REPORT_RING_SIZE - 1)].Droppable = Droppable;
+
+	LatencyRecordSince(&ReportContext->Latency, LATENCY_STAGE_REPORT_QUEUED, FrameStart);
+
+	//
+	// Publish the entry
+	//
+	InterlockedExchange(&ring->Head, head + 1);
+
+unlock:
+	WdfSpinLockRelease(ring->PushLock);
+
+	ReportDrainRing(ReportContext);
+
+	return status;
+}
 
 NTSTATUS
 ReportWakeup(
@@ -39,6 +229,7 @@ ReportWakeup(
 {
 	NTSTATUS status = STATUS_SUCCESS;
 	HID_INPUT_REPORT HidReport;
+	ULONG64 frameStart = LatencyFrameStart(&ReportContext->Latency);
 
 	RtlZeroMemory(&HidReport, sizeof(HID_INPUT_REPORT));
 
@@ -48,7 +239,7 @@ ReportWakeup(
 	HidReport.KeyReport.ACSearch = ReportContext->ButtonCache.ButtonSlots[2];
 	HidReport.KeyReport.SystemPowerDown = 1;
 
-	status = TchSendReport(ReportContext->PingPongQueue, &HidReport);
+	status = ReportSendHidReport(ReportContext, &HidReport, FALSE, frameStart);
 
 	if (!NT_SUCCESS(status))
 	{
@@ -69,7 +260,7 @@ ReportWakeup(
 	HidReport.KeyReport.ACSearch = ReportContext->ButtonCache.ButtonSlots[2];
 	HidReport.KeyReport.SystemPowerDown = 0;
 
-	status = TchSendReport(ReportContext->PingPongQueue, &HidReport);
+	status = ReportSendHidReport(ReportContext, &HidReport, FALSE, frameStart);
 
 	if (!NT_SUCCESS(status))
 	{
@@ -109,7 +300,11 @@ ReportKeypad(
 	ReportContext->ButtonCache.ButtonSlots[2] = Search;
 	HidReport.KeyReport.SystemPowerDown = 0;
 
-	status = TchSendReport(ReportContext->PingPongQueue, &HidReport);
+	status = ReportSendHidReport(
+		ReportContext,
+		&HidReport,
+		FALSE,
+		LatencyFrameStart(&ReportContext->Latency));
 
 	if (!NT_SUCCESS(status))
 	{
@@ -138,7 +333,8 @@ ReportPen(
 	IN USHORT  Y,
 	IN USHORT  TipPressure,
 	IN USHORT  XTilt,
-	IN USHORT  YTilt
+	IN USHORT  YTilt,
+	IN ULONG64 FrameStart
 )
 {
 	NTSTATUS status;
@@ -151,9 +347,10 @@ ReportPen(
 	//
 	// Perform per-platform x/y adjustments to controller coordinates
 	//
-	TchTranslateToDisplayCoordinates(
+	TchTranslateWithTable(
 		&ScratchX,
 		&ScratchY,
+		&ReportContext->Translation,
 		&ReportContext->Props);
 
 	HidReport.ReportID = REPORTID_STYLUS;
@@ -171,7 +368,10 @@ ReportPen(
 	HidReport.PenReport.XTilt = XTilt;
 	HidReport.PenReport.YTilt = YTilt;
 
-	status = TchSendReport(ReportContext->PingPongQueue, &HidReport);
+	//
+	// Only in range reports with the tip down are plain motion
+	//
+	status = ReportSendHidReport(ReportContext, &HidReport, TipSwitch && InRange, FrameStart);
 
 	if (!NT_SUCCESS(status))
 	{
@@ -190,7 +390,7 @@ exit:
 
 VOID
 ReportUpdateLocalObjectCache(
-	IN DETECTED_OBJECTS* Data,
+	IN OUT DETECTED_OBJECTS* Data,
 	IN OBJECT_CACHE* Cache
 )
 /*++
@@ -203,9 +403,13 @@ Routine Description:
 	order of reported touches in hardware, and the order the driver should
 	use in reporting.
 
+	Only slots flagged in Data->DirtyMask are read, the mask is cleared
+	once they have been applied to the cache.
+
 Arguments:
 
-	Data - A pointer to the new data returned from hardware
+	Data - A pointer to the new data returned from hardware, or NULL to
+		only retire the touches lifted in the last report
 	Cache - A data structure holding various current finger state info
 
 Return Value:
@@ -214,69 +418,91 @@ Return Value:
 
 --*/
 {
-	int i, j;
+	unsigned long i;
+	unsigned long slots;
+	ULONG64 QpcTimeStamp;
 
 	//
 	// When hardware was last read, if any slots reported as lifted, we
 	// must clean out the slot and old touch info. There may be new
 	// finger data using the slot.
 	//
-	for (i = 0; i < MAX_TOUCHES; i++)
-	{
-		//
-		// Sweep for a slot that needs to be cleaned
-		//
-		if (!(Cache->SlotDirty & (1 << i)))
-		{
-			continue;
-		}
+	slots = Cache->SlotDirty;
 
+	for_each_set_bit(i, &slots, MAX_TOUCHES)
+	{
 		NT_ASSERT(Cache->DownCount > 0);
 
 		//
-		// Find the slot in the reporting list 
+		// Unlink the slot from the reporting list
 		//
-		for (j = 0; j < MAX_TOUCHES; j++)
+		if (Cache->DownPrev[i] >= 0)
 		{
-			if (Cache->DownOrder[j] == i)
-			{
-				break;
-			}
+			Cache->DownNext[Cache->DownPrev[i]] = Cache->DownNext[i];
+		}
+		else
+		{
+			Cache->DownHead = Cache->DownNext[i];
 		}
 
-		NT_ASSERT(j != MAX_TOUCHES);
-
-		//
-		// Remove the slot. If the finger lifted was the last in the list,
-		// we just decrement the list total by one. If it was not last, we
-		// shift the trailing list items up by one.
-		//
-		for (; (j < Cache->DownCount - 1) && (j < MAX_TOUCHES - 1); j++)
+		if (Cache->DownNext[i] >= 0)
+		{
+			Cache->DownPrev[Cache->DownNext[i]] = Cache->DownPrev[i];
+		}
+		else
 		{
-			Cache->DownOrder[j] = Cache->DownOrder[j + 1];
+			Cache->DownTail = Cache->DownPrev[i];
 		}
+
 		Cache->DownCount--;
+	}
 
-		//
-		// Finished, clobber the dirty bit
-		//
-		Cache->SlotDirty &= ~(1 << i);
+	//
+	// Finished, clobber the dirty bits
+	//
+	Cache->PenSlots &= ~Cache->SlotDirty;
+	Cache->SlotDirty = 0;
+
+	if (Data == NULL)
+	{
+		goto exit;
 	}
 
 	//
-	// Cache the new set of finger data reported by hardware
+	// Cache the new set of finger data reported by hardware, only slots
+	// that changed since the last report carry new information
 	//
-	for (i = 0; i < MAX_TOUCHES; i++)
+	slots = Data->DirtyMask;
+	Data->DirtyMask = 0;
+
+	for_each_set_bit(i, &slots, MAX_TOUCHES)
 	{
 		//
 		// Take actions when a new contact is first reported as down
 		//
 		if ((Data->States[i] != OBJECT_STATE_NOT_PRESENT) &&
-			((Cache->SlotValid & (1 << i)) == 0) &&
-			(Cache->DownCount < MAX_TOUCHES))
+			((Cache->SlotValid & (1 << i)) == 0))
 		{
 			Cache->SlotValid |= (1 << i);
-			Cache->DownOrder[Cache->DownCount++] = i;
+
+			//
+			// Append the slot to the reporting list
+			//
+			Cache->DownNext[i] = -1;
+
+			if (Cache->DownCount == 0)
+			{
+				Cache->DownPrev[i] = -1;
+				Cache->DownHead = i;
+			}
+			else
+			{
+				Cache->DownPrev[i] = Cache->DownTail;
+				Cache->DownNext[Cache->DownTail] = i;
+			}
+
+			Cache->DownTail = i;
+			Cache->DownCount++;
 		}
 
 		//
@@ -296,6 +522,22 @@ Return Value:
 		{
 			Cache->Slot[i].x = Data->Positions[i].X;
 			Cache->Slot[i].y = Data->Positions[i].Y;
+			Cache->Slot[i].pressure = Data->Pressure[i];
+			Cache->Slot[i].size = Data->Size[i];
+		}
+
+		//
+		// A slot lifting keeps the kind of contact it had, so that a pen
+		// lifting is not reported as a finger
+		//
+		if (Cache->Slot[i].status == OBJECT_STATE_PEN_PRESENT_WITH_TIP ||
+			Cache->Slot[i].status == OBJECT_STATE_PEN_PRESENT_WITH_ERASER)
+		{
+			Cache->PenSlots |= (1 << i);
+		}
+		else if (Cache->Slot[i].status != OBJECT_STATE_NOT_PRESENT)
+		{
+			Cache->PenSlots &= ~(1 << i);
 		}
 
 		//
@@ -309,17 +551,18 @@ Return Value:
 		}
 	}
 
+exit:
 	//
 	// Get current scan time (in 100us units)
 	//
-	ULONG64 QpcTimeStamp;
 	Cache->ScanTime = KeQueryInterruptTimePrecise(&QpcTimeStamp) / 1000;
 }
 
 NTSTATUS
 ReportObjectsInternal(
 	IN PREPORT_CONTEXT ReportContext,
-	IN DETECTED_OBJECTS data
+	IN OUT DETECTED_OBJECTS* Data,
+	IN ULONG64 FrameStart
 )
 /*++
 
@@ -350,14 +593,19 @@ Return Value:
 	int TouchesReported = 0;
 	int currentFingerIndex;
 	int fingersToReport = 0;
-	USHORT SctatchX = 0, ScratchY = 0;
-	BOOLEAN HasPen = FALSE;
+	int nextToReport;
+	int frameSlots[MAX_TOUCHES];
+	USHORT frameX[MAX_TOUCHES];
+	USHORT frameY[MAX_TOUCHES];
+	int frameFingers = 0;
+	int penSlot = -1;
+	BOOLEAN droppable;
 
 	//
 	// Process the new touch data by updating our cached state
 	//
 	ReportUpdateLocalObjectCache(
-		&data,
+		Data,
 		&ReportContext->Cache);
 
 	//
@@ -369,7 +617,92 @@ Return Value:
 		goto exit;
 	}
 
-	while (TouchesReported != ReportContext->Cache.DownCount)
+	//
+	// Collect the finger contacts of the frame in reporting order and
+	// perform per-platform x/y adjustments to controller coordinates in
+	// one pass. Pens are reported through their own collection.
+	//
+	nextToReport = ReportContext->Cache.DownHead;
+
+	for (currentFingerIndex = 0; currentFingerIndex < ReportContext->Cache.DownCount; currentFingerIndex++)
+	{
+		if (ReportContext->Cache.PenSlots & (1 << nextToReport))
+		{
+			if (penSlot < 0 &&
+				ReportContext->Cache.Slot[nextToReport].status != OBJECT_STATE_NOT_PRESENT)
+			{
+				penSlot = nextToReport;
+			}
+		}
+		else
+		{
+			frameSlots[frameFingers] = nextToReport;
+			frameX[frameFingers] = (USHORT)ReportContext->Cache.Slot[nextToReport].x;
+			frameY[frameFingers] = (USHORT)ReportContext->Cache.Slot[nextToReport].y;
+			frameFingers++;
+		}
+
+		nextToReport = ReportContext->Cache.DownNext[nextToReport];
+	}
+
+	TchTranslateBatchWithTable(
+		frameX,
+		frameY,
+		(ULONG)frameFingers,
+		&ReportContext->Translation,
+		&ReportContext->Props);
+
+	if (penSlot >= 0)
+	{
+		OBJECT_INFO info = ReportContext->Cache.Slot[penSlot];
+
+		ReportContext->PenPresent = TRUE;
+
+		status = ReportPen(
+			ReportContext,
+			TRUE,
+			FALSE,
+			info.status == OBJECT_STATE_PEN_PRESENT_WITH_ERASER,
+			info.status == OBJECT_STATE_PEN_PRESENT_WITH_ERASER,
+			TRUE,
+			(USHORT)info.x,
+			(USHORT)info.y,
+			max(info.pressure, 1),
+			0,
+			0,
+			FrameStart);
+	}
+	else if (ReportContext->PenPresent)
+	{
+		ReportContext->PenPresent = FALSE;
+
+		status = ReportPen(
+			ReportContext,
+			FALSE,
+			FALSE,
+			FALSE,
+			FALSE,
+			FALSE,
+			0,
+			0,
+			0,
+			0,
+			0,
+			FrameStart);
+	}
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_REPORTING,
+			"Error sending hid report for passive pen - 0x%08lX",
+			status);
+
+		goto exit;
+	}
+
+	while (TouchesReported != frameFingers)
 	{
 		//
 		// Fill report with the next cached touches
@@ -378,7 +711,9 @@ Return Value:
 
 		currentFingerIndex = 0;
 
-		fingersToReport = min(ReportContext->Cache.DownCount - TouchesReported, 2);
+		fingersToReport = min(
+			frameFingers - TouchesReported,
+			(int)ReportContext->Props.ContactsPerReport);
 
 		HidReport.ReportID = REPORTID_FINGER;
 
@@ -389,8 +724,8 @@ Return Value:
 
 		//
 		// Report the count
-		// We're sending touches using hybrid mode with 5 fingers in our
-		// report descriptor. The first report must indicate the
+		// We're sending touches using hybrid mode with ContactsPerReport
+		// fingers in our report descriptor. The first report must indicate the
 		// total count of touch fingers detected by the digitizer.
 		// The remaining reports must indicate 0 for the count.
 		// The first report will have the TouchesReported integer set to 0
@@ -398,104 +733,46 @@ Return Value:
 		//
 		if (TouchesReported == 0)
 		{
-			HidReport.TouchReport.ContactCount = (UCHAR)ReportContext->Cache.DownCount;
+			HID_TOUCH_REPORT_CONTACT_COUNT(
+				&HidReport.TouchReport,
+				ReportContext->Props.ContactsPerReport) = (UCHAR)frameFingers;
 		}
 		else
 		{
-			HidReport.TouchReport.ContactCount = 0;
+			HID_TOUCH_REPORT_CONTACT_COUNT(
+				&HidReport.TouchReport,
+				ReportContext->Props.ContactsPerReport) = 0;
 		}
 
-		HasPen = FALSE;
+		droppable = frameFingers == fingersToReport;
 
 		for (currentFingerIndex = 0; currentFingerIndex < fingersToReport; currentFingerIndex++)
 		{
-			int currentlyReporting = ReportContext->Cache.DownOrder[TouchesReported];
-
+			int currentlyReporting = frameSlots[TouchesReported];
 			OBJECT_INFO info = ReportContext->Cache.Slot[currentlyReporting];
 
-			if (info.status == OBJECT_STATE_PEN_PRESENT_WITH_ERASER ||
-				info.status == OBJECT_STATE_PEN_PRESENT_WITH_TIP)
-			{
-				HasPen = TRUE;
-				ReportContext->PenPresent = TRUE;
-
-				status = ReportPen(
-					ReportContext,
-					TRUE,
-					FALSE,
-					info.status == OBJECT_STATE_PEN_PRESENT_WITH_ERASER,
-					info.status == OBJECT_STATE_PEN_PRESENT_WITH_ERASER,
-					TRUE,
-					(USHORT)info.x,
-					(USHORT)info.y,
-					1,
-					0,
-					0);
-				if (!NT_SUCCESS(status))
-				{
-					Trace(
-						TRACE_LEVEL_ERROR,
-						TRACE_REPORTING,
-						"Error sending hid report for passive pen - 0x%08lX",
-						status);
-
-					goto exit;
-				}
-			}
-
 			HidReport.TouchReport.Contacts[currentFingerIndex].ContactID = (UCHAR)currentlyReporting;
-			SctatchX = (USHORT)info.x;
-			ScratchY = (USHORT)info.y;
 			HidReport.TouchReport.Contacts[currentFingerIndex].Confidence = 1;
 
-			//
-			// Perform per-platform x/y adjustments to controller coordinates
-			//
-			TchTranslateToDisplayCoordinates(
-				&SctatchX,
-				&ScratchY,
-				&ReportContext->Props);
-
 			if (info.status == OBJECT_STATE_FINGER_PRESENT_WITH_ACCURATE_POS)
 			{
-				HidReport.TouchReport.Contacts[currentFingerIndex].X = SctatchX;
-				HidReport.TouchReport.Contacts[currentFingerIndex].Y = ScratchY;
+				HidReport.TouchReport.Contacts[currentFingerIndex].X = frameX[TouchesReported];
+				HidReport.TouchReport.Contacts[currentFingerIndex].Y = frameY[TouchesReported];
 				HidReport.TouchReport.Contacts[currentFingerIndex].TipSwitch = FINGER_STATUS;
 			}
-
-			TouchesReported++;
-		}
-
-		if (HasPen == FALSE && ReportContext->PenPresent == TRUE)
-		{
-			ReportContext->PenPresent = FALSE;
-
-			status = ReportPen(
-				ReportContext,
-				FALSE,
-				FALSE,
-				FALSE,
-				FALSE,
-				FALSE,
-				0,
-				0,
-				0,
-				0,
-				0);
-
-			if (!NT_SUCCESS(status))
+			else
 			{
-				Trace(
-					TRACE_LEVEL_ERROR,
-					TRACE_REPORTING,
-					"Error sending hid report for passive pen - 0x%08lX",
-					status);
-
-				goto exit;
+				droppable = FALSE;
 			}
+
+			TouchesReported++;
 		}
 
-		status = TchSendReport(ReportContext->PingPongQueue, &HidReport);
+		//
+		// A frame split over several reports must be delivered whole,
+		// otherwise only frames without lift-offs may be dropped
+		//
+		status = ReportSendHidReport(ReportContext, &HidReport, droppable, FrameStart);
 
 		if (!NT_SUCCESS(status))
 		{
@@ -513,79 +790,187 @@ exit:
 	return status;
 }
 
-NTSTATUS
+VOID
 TchContinuousObjectInterruptServicingEvtTimerFunc(
 	IN WDFTIMER Timer
 )
+/*++
+
+Routine Description:
+
+	Re-reports the contacts held on the screen once no report was sent
+	for a whole re-report interval, and re-arms itself for as long as
+	contacts are held.
+
+Arguments:
+
+	Timer - The continuous simulation timer
+
+Return Value:
+
+	None
+
+--*/
 {
 	NTSTATUS status = STATUS_SUCCESS;
+	PREPORT_CONTEXT reportContext;
+	ULONG64 now;
+	ULONG64 elapsed;
+	LONGLONG dueTime = 0;
 
-	Trace(
-		TRACE_LEVEL_ERROR,
+	TraceHot(
+		TRACE_LEVEL_VERBOSE,
 		TRACE_REPORTING,
 		"TchContinuousObjectInterruptServicingEvtTimerFunc ENTRY");
 
-	if (cachedReportContext == NULL)
+	reportContext = GetReportTimerContext(Timer)->ReportContext;
+
+	WdfSpinLockAcquire(reportContext->ReReportLock);
+
+	now = KeQueryInterruptTime();
+	elapsed = now - reportContext->LastReportTime;
+
+	if (reportContext->Cache.DownCount == 0)
 	{
-		Trace(
-			TRACE_LEVEL_ERROR,
-			TRACE_REPORTING,
-			"Error while reporting objects - cachedReportContext is NULL");
+		//
+		// All contacts lifted, the next frame re-arms the timer
+		//
+	}
+	else if (elapsed < reportContext->ReReportInterval)
+	{
+		//
+		// A report went out meanwhile, wait for the rest of the interval
+		//
+		dueTime = (LONGLONG)(reportContext->ReReportInterval - elapsed);
+	}
+	else
+	{
+		//
+		// Nothing changed since the last report, re-emit the cached state
+		//
+		status = ReportObjectsInternal(
+			reportContext,
+			NULL,
+			0);
 
-		WdfTimerStop(Timer, FALSE);
-		goto exit;
+		reportContext->LastReportTime = now;
+
+		if (NT_SUCCESS(status))
+		{
+			dueTime = (LONGLONG)reportContext->ReReportInterval;
+		}
 	}
 
-	status = ReportObjectsInternal(
-		cachedReportContext,
-		objectData);
+	if (dueTime == 0)
+	{
+		reportContext->ReReportArmed = FALSE;
+	}
 
-	if (!NT_SUCCESS(status))
+	WdfSpinLockRelease(reportContext->ReReportLock);
+
+	if (dueTime != 0)
+	{
+		WdfTimerStart(Timer, -dueTime);
+	}
+
+	if (!NT_SUCCESS(status) && status != STATUS_NO_DATA_DETECTED)
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_REPORTING,
 			"Error while reporting objects - 0x%08lX",
 			status);
-
-		WdfTimerStop(Timer, FALSE);
-		status = STATUS_SUCCESS;
-		goto exit;
 	}
 
-exit:
-	Trace(
-		TRACE_LEVEL_ERROR,
+	TraceHot(
+		TRACE_LEVEL_VERBOSE,
 		TRACE_REPORTING,
 		"TchContinuousObjectInterruptServicingEvtTimerFunc EXIT - 0x%08lX",
 		status);
-
-	return status;
 }
 
 NTSTATUS
 ReportConfigureContinuousSimulationTimer(
-	IN WDFDEVICE DeviceHandle
+	IN WDFDEVICE DeviceHandle,
+	IN PREPORT_CONTEXT ReportContext
 )
+/*++
+
+Routine Description:
+
+	Creates the high resolution one-shot timer used to re-report held
+	contacts on hardware that only reports changes, and sets up the
+	report ring from the screen properties.
+
+Arguments:
+
+	DeviceHandle - Handle to WDF Device Object
+	ReportContext - Report context of the device
+
+Return Value:
+
+	NTSTATUS indicating success or failure
+
+--*/
 {
 	NTSTATUS status = STATUS_SUCCESS;
 
 	WDF_TIMER_CONFIG  timerConfig;
 	WDF_OBJECT_ATTRIBUTES  timerAttributes;
+	WDF_OBJECT_ATTRIBUTES  lockAttributes;
+
+	WDF_OBJECT_ATTRIBUTES_INIT(&lockAttributes);
+	lockAttributes.ParentObject = DeviceHandle;
+
+	status = WdfSpinLockCreate(
+		&lockAttributes,
+		&ReportContext->ReReportLock);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_INIT,
+			"Error while creating the re-report lock - 0x%08lX",
+			status);
+
+		goto exit;
+	}
+
+	status = WdfSpinLockCreate(
+		&lockAttributes,
+		&ReportContext->Ring.PushLock);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_INIT,
+			"Error while creating the report ring lock - 0x%08lX",
+			status);
+
+		goto exit;
+	}
+
+	ReportContext->Ring.OverflowPolicy =
+		(REPORT_RING_OVERFLOW_POLICY)ReportContext->Props.ReportOverflowPolicy;
+
+	ReportContext->ReReportInterval =
+		TOUCH_RATE_TO_INTERVAL(ReportContext->Props.ContinuousReportRate);
 
 	WDF_TIMER_CONFIG_INIT(
 		&timerConfig,
 		TchContinuousObjectInterruptServicingEvtTimerFunc);
 
-	timerConfig.Period = 50;
+	timerConfig.UseHighResolutionTimer = WdfTrue;
 
-	WDF_OBJECT_ATTRIBUTES_INIT(&timerAttributes);
+	WDF_OBJECT_ATTRIBUTES_INIT_CONTEXT_TYPE(&timerAttributes, REPORT_TIMER_CONTEXT);
 	timerAttributes.ParentObject = DeviceHandle;
 
 	status = WdfTimerCreate(
 		&timerConfig,
 		&timerAttributes,
-		&timerHandle);
+		&ReportContext->ReReportTimer);
 
 	if (!NT_SUCCESS(status))
 	{
@@ -598,6 +983,8 @@ ReportConfigureContinuousSimulationTimer(
 		goto exit;
 	}
 
+	GetReportTimerContext(ReportContext->ReReportTimer)->ReportContext = ReportContext;
+
 exit:
 	return status;
 }
@@ -605,25 +992,54 @@ exit:
 NTSTATUS
 ReportObjectsContinuous(
 	IN PREPORT_CONTEXT ReportContext,
-	IN DETECTED_OBJECTS data
+	IN OUT DETECTED_OBJECTS* Data,
+	IN ULONG64 FrameStart
 )
+/*++
+
+Routine Description:
+
+	Reports a frame on hardware that lacks continuous reporting, and
+	makes sure the re-report timer runs while contacts are held. The
+	timer is never stopped here, it finds out by itself that a report
+	went out since it was armed.
+
+Arguments:
+
+	ReportContext - Report context of the device
+	Data - Detected objects of the new frame
+	FrameStart - Start of the frame, see ReportSendHidReport
+
+Return Value:
+
+	NTSTATUS indicating success or failure
+
+--*/
 {
 	NTSTATUS status = STATUS_SUCCESS;
+	BOOLEAN armTimer = FALSE;
 
-	Trace(
-		TRACE_LEVEL_ERROR,
+	TraceHot(
+		TRACE_LEVEL_VERBOSE,
 		TRACE_REPORTING,
 		"ReportObjectsContinuous ENTRY");
 
-	WdfTimerStop(timerHandle, TRUE);
-
-	cachedReportContext = ReportContext;
-
-	RtlCopyMemory(&objectData, &data, sizeof(objectData));
+	WdfSpinLockAcquire(ReportContext->ReReportLock);
 
 	status = ReportObjectsInternal(
 		ReportContext,
-		objectData);
+		Data,
+		FrameStart);
+
+	ReportContext->LastReportTime = KeQueryInterruptTime();
+
+	if (NT_SUCCESS(status) && !ReportContext->ReReportArmed)
+	{
+		ReportContext->ReReportArmed = TRUE;
+		armTimer = TRUE;
+	}
+
+	WdfSpinLockRelease(ReportContext->ReReportLock);
 
 	if (!NT_SUCCESS(status))
 	{
@@ -636,11 +1052,14 @@ ReportObjectsContinuous(
 		goto exit;
 	}
 
-	WdfTimerStart(timerHandle, WDF_REL_TIMEOUT_IN_MS(50));
+	if (armTimer)
+	{
+		WdfTimerStart(ReportContext->ReReportTimer, -(LONGLONG)ReportContext->ReReportInterval);
+	}
 
 exit:
-	Trace(
-		TRACE_LEVEL_ERROR,
+	TraceHot(
+		TRACE_LEVEL_VERBOSE,
 		TRACE_REPORTING,
 		"ReportObjectsContinuous EXIT - 0x%08lX",
 		status);
@@ -651,19 +1070,27 @@ exit:
 NTSTATUS
 ReportObjects(
 	IN PREPORT_CONTEXT ReportContext,
-	IN DETECTED_OBJECTS data
+	IN OUT DETECTED_OBJECTS* Data
 )
 {
+	//
+	// Taken here, on the thread servicing the interrupt, before the
+	// re-report lock raises IRQL
+	//
+	ULONG64 frameStart = LatencyFrameStart(&ReportContext->Latency);
+
 	if (ReportContext->Props.TouchHardwareLacksContinuousReporting)
 	{
 		return ReportObjectsContinuous(
 			ReportContext,
-			data);
+			Data,
+			frameStart);
 	}
 	else
 	{
 		return ReportObjectsInternal(
 			ReportContext,
-			data);
+			Data,
+			frameStart);
 	}
 }
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include <wdm.h>
 #include <controller.h>
 #include <resolutions.h>
+#include <HidCommon.h>
 #include <resolutions.tmh>
 
 //
@@ -53,7 +54,14 @@ TOUCH_SCREEN_PROPERTIES gDefaultProperties =
 	TOUCH_DEFAULT_RESOLUTION_Y,
 	0x0,
 	0x0,
-	0x0
+	0x0,
+	0x0,
+	0x0,
+	0x0,
+	0x0,
+	TOUCH_DEFAULT_CONTACTS_PER_REPORT,
+	TOUCH_DEFAULT_CONTINUOUS_REPORT_RATE,
+	TOUCH_DEFAULT_REPORT_OVERFLOW_POLICY
 };
 
 
@@ -227,6 +235,30 @@ RTL_QUERY_REGISTRY_TABLE gResParamsRegTable[] =
 		&gDefaultProperties.TouchHardwareLacksContinuousReporting,
 		sizeof(ULONG)
 	},
+	{
+		NULL, RTL_QUERY_REGISTRY_DIRECT,
+		L"ContactsPerReport",
+		(PVOID)(FIELD_OFFSET(TOUCH_SCREEN_PROPERTIES, ContactsPerReport)),
+		REG_DWORD,
+		&gDefaultProperties.ContactsPerReport,
+		sizeof(ULONG)
+	},
+	{
+		NULL, RTL_QUERY_REGISTRY_DIRECT,
+		L"ContinuousReportRate",
+		(PVOID)(FIELD_OFFSET(TOUCH_SCREEN_PROPERTIES, ContinuousReportRate)),
+		REG_DWORD,
+		&gDefaultProperties.ContinuousReportRate,
+		sizeof(ULONG)
+	},
+	{
+		NULL, RTL_QUERY_REGISTRY_DIRECT,
+		L"ReportOverflowPolicy",
+		(PVOID)(FIELD_OFFSET(TOUCH_SCREEN_PROPERTIES, ReportOverflowPolicy)),
+		REG_DWORD,
+		&gDefaultProperties.ReportOverflowPolicy,
+		sizeof(ULONG)
+	},
 	//
 	// List Terminator - set to NULL to indicate end of table
 	//
@@ -404,6 +436,170 @@ TchTranslateToDisplayCoordinates(
 	*PY = (USHORT)Y;
 }
 
+VOID
+TchBuildTranslation(
+	OUT PTOUCH_TRANSLATION Translation,
+	IN PTOUCH_SCREEN_PROPERTIES Props
+)
+/*++
+
+  Routine Description:
+
+	This routine precomputes TchTranslateToDisplayCoordinates for every
+	controller coordinate. Each display axis only depends on one touch
+	axis, so translating the point (v, v) yields the display X for touch
+	value v and the display Y for touch value v at once, whichever touch
+	axis they come from.
+
+  Arguments:
+
+	Translation - receives the per axis tables
+	Props - pointer to screen information
+
+  Return Value:
+
+	None.
+
+--*/
+{
+	USHORT i;
+	USHORT X;
+	USHORT Y;
+
+	Translation->SwapAxes = Props->TouchSwapAxes ? 1 : 0;
+
+	for (i = 0; i < TOUCH_TRANSLATION_TABLE_SIZE; i++)
+	{
+		X = i;
+		Y = i;
+
+		TchTranslateToDisplayCoordinates(&X, &Y, Props);
+
+		Translation->X[i] = X;
+		Translation->Y[i] = Y;
+	}
+}
+
+VOID
+TchTranslateWithTable(
+	IN PUSHORT PX,
+	IN PUSHORT PY,
+	IN PTOUCH_TRANSLATION Translation,
+	IN PTOUCH_SCREEN_PROPERTIES Props
+)
+/*++
+
+  Routine Description:
+
+	This routine translates touch coordinates to display coordinates
+	using the tables built by TchBuildTranslation. Coordinates outside
+	of the tables go through TchTranslateToDisplayCoordinates.
+
+  Arguments:
+
+	X - pointer to the pre-processed X coordinate
+	Y - pointer the pre-processed Y coordinate
+	Translation - pointer to the precomputed tables
+	Props - pointer to screen information
+
+  Return Value:
+
+	None. The X/Y values will be modified by this function.
+
+--*/
+{
+	USHORT in[2];
+
+	in[0] = *PX;
+	in[1] = *PY;
+
+	if (in[0] >= TOUCH_TRANSLATION_TABLE_SIZE ||
+		in[1] >= TOUCH_TRANSLATION_TABLE_SIZE)
+	{
+		TchTranslateToDisplayCoordinates(PX, PY, Props);
+		return;
+	}
+
+	*PX = Translation->X[in[Translation->SwapAxes]];
+	*PY = Translation->Y[in[Translation->SwapAxes ^ 1]];
+}
+
+VOID
+TchTranslateBatchWithTable(
+	IN OUT PUSHORT X,
+	IN OUT PUSHORT Y,
+	IN ULONG Count,
+	IN PTOUCH_TRANSLATION Translation,
+	IN PTOUCH_SCREEN_PROPERTIES Props
+)
+/*++
+
+  Routine Description:
+
+	This routine translates the touch coordinates of a whole frame to
+	display coordinates. The axes are swapped up front when requested so
+	each table is then walked on its own.
+
+  Arguments:
+
+	X - array of pre-processed X coordinates
+	Y - array of pre-processed Y coordinates
+	Count - number of coordinates in X and Y
+	Translation - pointer to the precomputed tables
+	Props - pointer to screen information
+
+  Return Value:
+
+	None. The X/Y values will be modified by this function.
+
+--*/
+{
+	ULONG i;
+	USHORT temp;
+
+	for (i = 0; i < Count; i++)
+	{
+		if (X[i] >= TOUCH_TRANSLATION_TABLE_SIZE ||
+			Y[i] >= TOUCH_TRANSLATION_TABLE_SIZE)
+		{
+			break;
+		}
+	}
+
+	//
+	// Rare out of range coordinates take the slow path for the frame
+	//
+	if (i != Count)
+	{
+		for (i = 0; i < Count; i++)
+		{
+			TchTranslateToDisplayCoordinates(&X[i], &Y[i], Props);
+		}
+
+		return;
+	}
+
+	if (Translation->SwapAxes)
+	{
+		for (i = 0; i < Count; i++)
+		{
+			temp = X[i];
+			X[i] = Y[i];
+			Y[i] = temp;
+		}
+	}
+
+	for (i = 0; i < Count; i++)
+	{
+		X[i] = Translation->X[X[i]];
+	}
+
+	for (i = 0; i < Count; i++)
+	{
+		Y[i] = Translation->Y[Y[i]];
+	}
+}
+
 VOID
 TchGetScreenProperties(
 	IN PTOUCH_SCREEN_PROPERTIES Props
@@ -528,6 +724,44 @@ TchGetScreenProperties(
 			gDefaultProperties.TouchLetterBoxHeightBottom;
 	}
 
+	if (!TOUCH_CONTACTS_PER_REPORT_SUPPORTED(Props->ContactsPerReport))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_REGISTRY,
+			"Unsupported number of contacts per report provided (%d, up to %d)",
+			Props->ContactsPerReport,
+			TOUCH_MAX_CONTACTS_PER_REPORT);
+
+		Props->ContactsPerReport =
+			gDefaultProperties.ContactsPerReport;
+	}
+
+	if (Props->ContinuousReportRate == 0 ||
+		Props->ContinuousReportRate > TOUCH_MAX_CONTINUOUS_REPORT_RATE)
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_REGISTRY,
+			"Invalid continuous report rate provided (%d Hz)",
+			Props->ContinuousReportRate);
+
+		Props->ContinuousReportRate =
+			gDefaultProperties.ContinuousReportRate;
+	}
+
+	if (Props->ReportOverflowPolicy > TOUCH_MAX_REPORT_OVERFLOW_POLICY)
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_REGISTRY,
+			"Invalid report overflow policy provided (%d)",
+			Props->ReportOverflowPolicy);
+
+		Props->ReportOverflowPolicy =
+			gDefaultProperties.ReportOverflowPolicy;
+	}
+
 	if (regTable != NULL)
 	{
 		ExFreePoolWithTag(regTable, TOUCH_POOL_TAG);
@@ -24,7 +24,7 @@
 #include <internal.h>
 #include <controller.h>
 #include <fts\ftsinternal.h>
-#include <spb.h>
+#include <spbhelper.h>
 #include <initguid.h>
 #include <devguid.h>
 #include <selftest\enoselftest.h>
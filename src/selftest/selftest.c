@@ -24,12 +24,16 @@
 #include <internal.h>
 #include <controller.h>
 #include <fts\ftsinternal.h>
-#include <spb.h>
+#include <fts\ftsevents.h>
+#include <spbhelper.h>
 #include <initguid.h>
 #include <devguid.h>
 #include <selftest\selftest.h>
 #include <selftest.tmh>
 
+C_ASSERT(TOUCH_TEST_LATENCY_STAGES == LATENCY_STAGE_COUNT);
+C_ASSERT(TOUCH_TEST_LATENCY_BUCKETS == LATENCY_HISTOGRAM_BUCKETS);
+
 VOID
 TchSelfTestOnDeviceControl(
 	IN WDFQUEUE Queue,
@@ -68,6 +72,9 @@ Return Value:
 	NTSTATUS status = STATUS_INVALID_PARAMETER;
 	BOOLEAN* requestedDiagnosticMode;
 	UCHAR* requestedPage;
+	BYTE* replayEvents;
+	BOOLEAN* resetLatency;
+	TOUCH_TEST_LATENCY_HISTOGRAM* latencyHistogram;
 
 
 	devContext = GetDeviceContext(WdfPdoGetParent(WdfIoQueueGetDevice(Queue)));
@@ -258,6 +265,101 @@ Return Value:
 		break;
 	}
 
+	case IOCTL_TOUCH_SELFTEST_REPLAY:
+	{
+		//
+		// Validate parameters and memory
+		//
+		if (InputBufferLength == 0 ||
+			InputBufferLength % FIFO_EVENT_SIZE != 0 ||
+			InputBufferLength > TOUCH_TEST_REPLAY_MAX_EVENTS * FIFO_EVENT_SIZE)
+		{
+			status = STATUS_INVALID_PARAMETER;
+			goto exit;
+		}
+
+		status = WdfRequestRetrieveInputBuffer(
+			Request,
+			InputBufferLength,
+			(PVOID)&replayEvents,
+			NULL);
+
+		if (!NT_SUCCESS(status))
+		{
+			status = STATUS_INVALID_PARAMETER;
+			goto exit;
+		}
+
+		status = TchReplayObjectEvents(
+			devContext->TouchContext,
+			&devContext->ReportContext,
+			replayEvents,
+			(DWORD)InputBufferLength);
+
+		if (!NT_SUCCESS(status))
+		{
+			goto exit;
+		}
+
+		WdfRequestSetInformation(Request, InputBufferLength);
+
+		break;
+	}
+
+	case IOCTL_TOUCH_SELFTEST_LATENCY:
+	{
+		//
+		// Validate parameters and memory
+		//
+		if ((InputBufferLength != 0 && InputBufferLength != sizeof(BOOLEAN)) ||
+			OutputBufferLength < sizeof(TOUCH_TEST_LATENCY_HISTOGRAM))
+		{
+			status = STATUS_INVALID_PARAMETER;
+			goto exit;
+		}
+
+		resetLatency = NULL;
+
+		if (InputBufferLength != 0)
+		{
+			status = WdfRequestRetrieveInputBuffer(
+				Request,
+				sizeof(BOOLEAN),
+				(PVOID)&resetLatency,
+				NULL);
+
+			if (!NT_SUCCESS(status))
+			{
+				status = STATUS_INVALID_PARAMETER;
+				goto exit;
+			}
+		}
+
+		status = WdfRequestRetrieveOutputBuffer(
+			Request,
+			sizeof(TOUCH_TEST_LATENCY_HISTOGRAM),
+			(PVOID)&latencyHistogram,
+			NULL);
+
+		if (!NT_SUCCESS(status))
+		{
+			status = STATUS_INVALID_PARAMETER;
+			goto exit;
+		}
+
+		//
+		// Input and output share the system buffer, read the input first
+		//
+		LatencyReadHistogram(
+			&devContext->ReportContext.Latency,
+			&latencyHistogram->Count[0][0],
+			resetLatency != NULL && *resetLatency != FALSE);
+
+		WdfRequestSetInformation(Request, sizeof(TOUCH_TEST_LATENCY_HISTOGRAM));
+
+		break;
+	}
+
 	default:
 	{
 		status = STATUS_NOT_IMPLEMENTED;
@@ -21,11 +21,109 @@
 
 #include <internal.h>
 #include <controller.h>
-#include "spb.h"
+#include <spbhelper.h>
+#include <spb.h>
 #include <spb.tmh>
 
 #define I2C_VERBOSE_LOGGING 0
 
+//
+// Storage for an asynchronous read, kept alive until the request completes
+//
+typedef struct _SPB_ASYNC_SEQUENCE
+{
+	SPB_TRANSFER_LIST_AND_ENTRIES(2) Sequence;
+	UCHAR Address;
+} SPB_ASYNC_SEQUENCE;
+
+//
+// Sizes of the preallocated buffers, large enough for register accesses,
+// a full FIFO drain and self-test frames respectively
+//
+static const ULONG gSpbBufferClassSizes[SPB_BUFFER_CLASS_COUNT] =
+{
+	DEFAULT_SPB_BUFFER_SIZE,
+	SPB_FIFO_BUFFER_SIZE,
+	SPB_LARGE_BUFFER_SIZE
+};
+
+static NTSTATUS
+SpbAcquireBuffer(
+	IN SPB_CONTEXT* SpbContext,
+	IN ULONG Length,
+	OUT PWDF_MEMORY_DESCRIPTOR MemoryDescriptor,
+	OUT PUCHAR* Buffer,
+	OUT WDFMEMORY* Memory
+)
+/*++
+
+  Routine Description:
+
+	This helper routine picks the smallest preallocated buffer that can
+	hold a transfer, and only allocates when the transfer is larger than
+	all of them. Must be called with the SpbLock held.
+
+  Arguments:
+
+	SpbContext       - Pointer to the current device context
+	Length           - The length of the transfer
+	MemoryDescriptor - Receives a descriptor for the buffer
+	Buffer           - Receives the buffer
+	Memory           - Receives the memory object to delete after the
+	                   transfer, NULL when a preallocated buffer was used
+
+  Return Value:
+
+	NTSTATUS Status indicating success or failure
+
+--*/
+{
+	NTSTATUS status;
+	ULONG sizeClass;
+
+	*Memory = NULL;
+
+	for (sizeClass = 0; sizeClass < SPB_BUFFER_CLASS_COUNT; sizeClass++)
+	{
+		if (Length <= gSpbBufferClassSizes[sizeClass])
+		{
+			*Buffer = (PUCHAR)WdfMemoryGetBuffer(SpbContext->BufferPool[sizeClass], NULL);
+			SpbContext->BufferPoolHits[sizeClass]++;
+
+			WDF_MEMORY_DESCRIPTOR_INIT_BUFFER(
+				MemoryDescriptor,
+				(PVOID)*Buffer,
+				Length);
+
+			status = STATUS_SUCCESS;
+			goto exit;
+		}
+	}
+
+	SpbContext->BufferPoolMisses++;
+
+	status = WdfMemoryCreate(
+		WDF_NO_OBJECT_ATTRIBUTES,
+		NonPagedPool,
+		TOUCH_POOL_TAG,
+		Length,
+		Memory,
+		(PVOID*)Buffer);
+
+	if (!NT_SUCCESS(status))
+	{
+		goto exit;
+	}
+
+	WDF_MEMORY_DESCRIPTOR_INIT_HANDLE(
+		MemoryDescriptor,
+		*Memory,
+		NULL);
+
+exit:
+	return status;
+}
+
 NTSTATUS
 SpbDoWriteDataSynchronously(
 	IN SPB_CONTEXT* SpbContext,
@@ -66,39 +164,21 @@ SpbDoWriteDataSynchronously(
 	length = Length + 1;
 	memory = NULL;
 
-	if (length > DEFAULT_SPB_BUFFER_SIZE)
-	{
-		status = WdfMemoryCreate(
-			WDF_NO_OBJECT_ATTRIBUTES,
-			NonPagedPool,
-			TOUCH_POOL_TAG,
-			length,
-			&memory,
-			&buffer);
-
-		if (!NT_SUCCESS(status))
-		{
-			Trace(
-				TRACE_LEVEL_ERROR,
-				TRACE_SPB,
-				"Error allocating memory for Spb write - 0x%08lX",
-				status);
-			goto exit;
-		}
+	status = SpbAcquireBuffer(
+		SpbContext,
+		length,
+		&memoryDescriptor,
+		&buffer,
+		&memory);
 
-		WDF_MEMORY_DESCRIPTOR_INIT_HANDLE(
-			&memoryDescriptor,
-			memory,
-			NULL);
-	}
-	else
+	if (!NT_SUCCESS(status))
 	{
-		buffer = (PUCHAR)WdfMemoryGetBuffer(SpbContext->WriteMemory, NULL);
-
-		WDF_MEMORY_DESCRIPTOR_INIT_BUFFER(
-			&memoryDescriptor,
-			(PVOID)buffer,
-			length);
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_SPB,
+			"Error allocating memory for Spb write - 0x%08lX",
+			status);
+		goto exit;
 	}
 
 	//
@@ -192,10 +272,9 @@ SpbWriteDataSynchronously(
 	return status;
 }
 
-NTSTATUS
-SpbReadDataSynchronously(
+static NTSTATUS
+SpbDoReadDataSynchronously(
 	IN SPB_CONTEXT* SpbContext,
-	IN UCHAR Address,
 	_In_reads_bytes_(Length) PVOID Data,
 	IN ULONG Length
 )
@@ -204,14 +283,14 @@ SpbReadDataSynchronously(
   Routine Description:
 
 	This helper routine abstracts creating and sending an I/O
-	request (I2C Read) to the Spb I/O target.
+	request (I2C Read) to the Spb I/O target once the address
+	pointer has been written. Must be called with the SpbLock held.
 
   Arguments:
 
 	SpbContext - Pointer to the current device context
-	Address    - The I2C register address to read from
-	Data       - A buffer to receive the data at at the above address
-	Length     - The amount of data to be read from the above address
+	Data       - A buffer to receive the data
+	Length     - The amount of data to be read
 
   Return Value:
 
@@ -225,67 +304,26 @@ SpbReadDataSynchronously(
 	NTSTATUS status;
 	ULONG_PTR bytesRead;
 
-	WdfWaitLockAcquire(SpbContext->SpbLock, NULL);
-
 	memory = NULL;
-	status = STATUS_INVALID_PARAMETER;
 	bytesRead = 0;
 
-	//
-	// Read transactions start by writing an address pointer
-	//
-	status = SpbDoWriteDataSynchronously(
+	status = SpbAcquireBuffer(
 		SpbContext,
-		Address,
-		NULL,
-		0);
+		Length,
+		&memoryDescriptor,
+		&buffer,
+		&memory);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_SPB,
-			"Error setting address pointer for Spb read - 0x%08lX",
+			"Error allocating memory for Spb read - 0x%08lX",
 			status);
 		goto exit;
 	}
 
-	if (Length > DEFAULT_SPB_BUFFER_SIZE)
-	{
-		status = WdfMemoryCreate(
-			WDF_NO_OBJECT_ATTRIBUTES,
-			NonPagedPool,
-			TOUCH_POOL_TAG,
-			Length,
-			&memory,
-			&buffer);
-
-		if (!NT_SUCCESS(status))
-		{
-			Trace(
-				TRACE_LEVEL_ERROR,
-				TRACE_SPB,
-				"Error allocating memory for Spb read - 0x%08lX",
-				status);
-			goto exit;
-		}
-
-		WDF_MEMORY_DESCRIPTOR_INIT_HANDLE(
-			&memoryDescriptor,
-			memory,
-			NULL);
-	}
-	else
-	{
-		buffer = (PUCHAR)WdfMemoryGetBuffer(SpbContext->ReadMemory, NULL);
-
-		WDF_MEMORY_DESCRIPTOR_INIT_BUFFER(
-			&memoryDescriptor,
-			(PVOID)buffer,
-			Length);
-	}
-
-
 	status = WdfIoTargetSendReadSynchronously(
 		SpbContext->SpbIoTarget,
 		NULL,
@@ -326,6 +364,536 @@ exit:
 		WdfObjectDelete(memory);
 	}
 
+	return status;
+}
+
+static NTSTATUS
+SpbDoWriteReadSynchronously(
+	IN SPB_CONTEXT* SpbContext,
+	IN UCHAR Address,
+	IN PVOID Register,
+	IN ULONG RegisterLength,
+	_In_reads_bytes_(Length) PVOID Data,
+	IN ULONG Length
+)
+/*++
+
+  Routine Description:
+
+	This helper routine writes an address pointer and reads back from it.
+	Both halves are submitted as a single IOCTL_SPB_EXECUTE_SEQUENCE
+	request so the controller sees a repeated start instead of a stop
+	between them. Controllers that do not support sequences fall back
+	to a separate write and read. Must be called with the SpbLock held.
+
+  Arguments:
+
+	SpbContext     - Pointer to the current device context
+	Address        - The I2C register address to read from
+	Register       - Optional bytes following the address
+	RegisterLength - The length of the optional bytes
+	Data           - A buffer to receive the data at at the above address
+	Length         - The amount of data to be read from the above address
+
+  Return Value:
+
+	NTSTATUS Status indicating success or failure
+
+--*/
+{
+	PUCHAR buffer;
+	ULONG length;
+	SPB_TRANSFER_LIST_AND_ENTRIES(2) sequence;
+	WDF_MEMORY_DESCRIPTOR memoryDescriptor;
+	NTSTATUS status;
+	ULONG_PTR bytesTransferred;
+
+	bytesTransferred = 0;
+
+	if (SpbContext->SequenceUnsupported)
+	{
+		goto legacy;
+	}
+
+	length = RegisterLength + 1;
+
+	if (length > gSpbBufferClassSizes[0])
+	{
+		goto legacy;
+	}
+
+	//
+	// The address pointer and register bytes form the write half
+	//
+	buffer = (PUCHAR)WdfMemoryGetBuffer(SpbContext->BufferPool[0], NULL);
+	SpbContext->BufferPoolHits[0]++;
+
+	RtlCopyMemory(buffer, &Address, sizeof(Address));
+	RtlCopyMemory((buffer + sizeof(Address)), Register, RegisterLength);
+
+	SPB_TRANSFER_LIST_INIT(&(sequence.List), 2);
+
+	sequence.List.Transfers[0] = SPB_TRANSFER_LIST_ENTRY_INIT_SIMPLE(
+		SpbTransferDirectionToDevice,
+		0,
+		buffer,
+		length);
+
+	sequence.List.Transfers[1] = SPB_TRANSFER_LIST_ENTRY_INIT_SIMPLE(
+		SpbTransferDirectionFromDevice,
+		0,
+		Data,
+		Length);
+
+	WDF_MEMORY_DESCRIPTOR_INIT_BUFFER(
+		&memoryDescriptor,
+		(PVOID)&sequence,
+		sizeof(sequence));
+
+	status = WdfIoTargetSendIoctlSynchronously(
+		SpbContext->SpbIoTarget,
+		NULL,
+		IOCTL_SPB_EXECUTE_SEQUENCE,
+		&memoryDescriptor,
+		NULL,
+		NULL,
+		&bytesTransferred);
+
+	if (status == STATUS_NOT_SUPPORTED ||
+		status == STATUS_INVALID_DEVICE_REQUEST)
+	{
+		Trace(
+			TRACE_LEVEL_WARNING,
+			TRACE_SPB,
+			"Spb controller does not support sequences, using separate transfers - 0x%08lX",
+			status);
+
+		SpbContext->SequenceUnsupported = TRUE;
+		goto legacy;
+	}
+
+	if (!NT_SUCCESS(status) ||
+		bytesTransferred != length + Length)
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_SPB,
+			"Error executing Spb read sequence - 0x%08lX",
+			status);
+
+		if (NT_SUCCESS(status))
+		{
+			status = STATUS_DEVICE_PROTOCOL_ERROR;
+		}
+
+		goto exit;
+	}
+
+#if I2C_VERBOSE_LOGGING
+	DbgPrintEx(DPFLTR_IHVDRIVER_ID, DPFLTR_ERROR_LEVEL, "I2CSEQREAD: LENGTH=%d", Length);
+	for (ULONG j = 0; j < Length; j++)
+	{
+		UCHAR byte = *((PUCHAR)Data + j);
+		DbgPrintEx(DPFLTR_IHVDRIVER_ID, DPFLTR_ERROR_LEVEL, " %02hhX", byte);
+	}
+	DbgPrintEx(DPFLTR_IHVDRIVER_ID, DPFLTR_ERROR_LEVEL, "\n");
+#endif
+
+	goto exit;
+
+legacy:
+	//
+	// Read transactions start by writing an address pointer
+	//
+	status = SpbDoWriteDataSynchronously(
+		SpbContext,
+		Address,
+		Register,
+		RegisterLength);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_SPB,
+			"Error setting address pointer for Spb read - 0x%08lX",
+			status);
+		goto exit;
+	}
+
+	status = SpbDoReadDataSynchronously(
+		SpbContext,
+		Data,
+		Length);
+
+exit:
+	return status;
+}
+
+NTSTATUS
+SpbReadDataSynchronously(
+	IN SPB_CONTEXT* SpbContext,
+	IN UCHAR Address,
+	_In_reads_bytes_(Length) PVOID Data,
+	IN ULONG Length
+)
+/*++
+
+  Routine Description:
+
+	This helper routine abstracts creating and sending an I/O
+	request (I2C Read) to the Spb I/O target.
+
+  Arguments:
+
+	SpbContext - Pointer to the current device context
+	Address    - The I2C register address to read from
+	Data       - A buffer to receive the data at at the above address
+	Length     - The amount of data to be read from the above address
+
+  Return Value:
+
+	NTSTATUS Status indicating success or failure
+
+--*/
+{
+	NTSTATUS status;
+
+	WdfWaitLockAcquire(SpbContext->SpbLock, NULL);
+
+	status = SpbDoWriteReadSynchronously(
+		SpbContext,
+		Address,
+		NULL,
+		0,
+		Data,
+		Length);
+
+	WdfWaitLockRelease(SpbContext->SpbLock);
+
+	return status;
+}
+
+NTSTATUS
+SpbReadRegisterSynchronously(
+	IN SPB_CONTEXT* SpbContext,
+	IN UCHAR Command,
+	IN PVOID Register,
+	IN ULONG RegisterLength,
+	_In_reads_bytes_(Length) PVOID Data,
+	IN ULONG Length
+)
+/*++
+
+  Routine Description:
+
+	This helper routine reads from a register that is addressed by a
+	command byte followed by a multi-byte register address, such as
+	the hardware registers behind FTS_CMD_HW_REG_R.
+
+  Arguments:
+
+	SpbContext     - Pointer to the current device context
+	Command        - The command byte selecting the register space
+	Register       - The register address bytes following the command
+	RegisterLength - The length of the register address
+	Data           - A buffer to receive the data at at the above address
+	Length         - The amount of data to be read from the above address
+
+  Return Value:
+
+	NTSTATUS Status indicating success or failure
+
+--*/
+{
+	NTSTATUS status;
+
+	WdfWaitLockAcquire(SpbContext->SpbLock, NULL);
+
+	status = SpbDoWriteReadSynchronously(
+		SpbContext,
+		Command,
+		Register,
+		RegisterLength,
+		Data,
+		Length);
+
+	WdfWaitLockRelease(SpbContext->SpbLock);
+
+	return status;
+}
+
+EVT_WDF_REQUEST_COMPLETION_ROUTINE SpbAsyncReadCompletion;
+
+VOID
+SpbAsyncReadCompletion(
+	IN WDFREQUEST Request,
+	IN WDFIOTARGET Target,
+	IN PWDF_REQUEST_COMPLETION_PARAMS Params,
+	IN WDFCONTEXT Context
+)
+/*++
+
+  Routine Description:
+
+	Completion routine for asynchronous reads. Records the result, runs
+	the caller's completion callback and wakes up any waiter. May run at
+	DISPATCH_LEVEL.
+
+  Arguments:
+
+	Request - The asynchronous read request
+	Target  - The Spb I/O target
+	Params  - Completion parameters of the request
+	Context - Pointer to the current device context
+
+  Return Value:
+
+	None
+
+--*/
+{
+	SPB_CONTEXT* SpbContext = (SPB_CONTEXT*)Context;
+	NTSTATUS status;
+
+	UNREFERENCED_PARAMETER(Request);
+	UNREFERENCED_PARAMETER(Target);
+
+	status = Params->IoStatus.Status;
+
+	if (status == STATUS_NOT_SUPPORTED ||
+		status == STATUS_INVALID_DEVICE_REQUEST)
+	{
+		//
+		// Retried with separate transfers from the waiter at passive level
+		//
+		SpbContext->SequenceUnsupported = TRUE;
+	}
+	else if (NT_SUCCESS(status) &&
+		Params->IoStatus.Information != sizeof(UCHAR) + SpbContext->AsyncLength)
+	{
+		status = STATUS_DEVICE_PROTOCOL_ERROR;
+	}
+
+	SpbContext->AsyncStatus = status;
+
+	if (SpbContext->AsyncCompletion != NULL && !SpbContext->SequenceUnsupported)
+	{
+		SpbContext->AsyncCompletion(
+			SpbContext,
+			status,
+			SpbContext->AsyncCompletionContext);
+	}
+
+	KeSetEvent(&SpbContext->AsyncCompleted, IO_NO_INCREMENT, FALSE);
+}
+
+NTSTATUS
+SpbReadDataAsynchronously(
+	IN SPB_CONTEXT* SpbContext,
+	IN UCHAR Address,
+	_In_reads_bytes_(Length) PVOID Data,
+	IN ULONG Length,
+	IN PFN_SPB_ASYNC_COMPLETION Completion,
+	IN PVOID CompletionContext
+)
+/*++
+
+  Routine Description:
+
+	This routine starts a read using the preallocated asynchronous request
+	and returns without waiting for the bus. The SpbLock stays held until
+	SpbWaitForAsynchronousRead is called from the same thread, which must
+	happen before any other Spb access. Data must stay valid until then.
+
+  Arguments:
+
+	SpbContext        - Pointer to the current device context
+	Address           - The I2C register address to read from
+	Data              - A buffer to receive the data at at the above address
+	Length            - The amount of data to be read from the above address
+	Completion        - Optional callback run when the read completes
+	CompletionContext - Context passed to the callback
+
+  Return Value:
+
+	NTSTATUS Status indicating success or failure, on failure no read is
+	outstanding and SpbWaitForAsynchronousRead must not be called
+
+--*/
+{
+	SPB_ASYNC_SEQUENCE* asyncSequence;
+	WDF_REQUEST_REUSE_PARAMS reuseParams;
+	NTSTATUS status;
+
+	WdfWaitLockAcquire(SpbContext->SpbLock, NULL);
+
+	SpbContext->AsyncAddress = Address;
+	SpbContext->AsyncData = Data;
+	SpbContext->AsyncLength = Length;
+	SpbContext->AsyncCompletion = Completion;
+	SpbContext->AsyncCompletionContext = CompletionContext;
+	SpbContext->AsyncStatus = STATUS_PENDING;
+
+	KeClearEvent(&SpbContext->AsyncCompleted);
+
+	if (SpbContext->SequenceUnsupported)
+	{
+		//
+		// Nothing to overlap with, the waiter performs the read
+		//
+		KeSetEvent(&SpbContext->AsyncCompleted, IO_NO_INCREMENT, FALSE);
+		status = STATUS_SUCCESS;
+		goto exit;
+	}
+
+	asyncSequence = (SPB_ASYNC_SEQUENCE*)WdfMemoryGetBuffer(SpbContext->AsyncMemory, NULL);
+	asyncSequence->Address = Address;
+
+	SPB_TRANSFER_LIST_INIT(&(asyncSequence->Sequence.List), 2);
+
+	asyncSequence->Sequence.List.Transfers[0] = SPB_TRANSFER_LIST_ENTRY_INIT_SIMPLE(
+		SpbTransferDirectionToDevice,
+		0,
+		&asyncSequence->Address,
+		sizeof(asyncSequence->Address));
+
+	asyncSequence->Sequence.List.Transfers[1] = SPB_TRANSFER_LIST_ENTRY_INIT_SIMPLE(
+		SpbTransferDirectionFromDevice,
+		0,
+		Data,
+		Length);
+
+	WDF_REQUEST_REUSE_PARAMS_INIT(
+		&reuseParams,
+		WDF_REQUEST_REUSE_NO_FLAGS,
+		STATUS_SUCCESS);
+
+	status = WdfRequestReuse(SpbContext->AsyncRequest, &reuseParams);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_SPB,
+			"Error reusing Spb async request - 0x%08lX",
+			status);
+		goto exit;
+	}
+
+	status = WdfIoTargetFormatRequestForIoctl(
+		SpbContext->SpbIoTarget,
+		SpbContext->AsyncRequest,
+		IOCTL_SPB_EXECUTE_SEQUENCE,
+		SpbContext->AsyncMemory,
+		NULL,
+		NULL,
+		NULL);
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_SPB,
+			"Error formatting Spb async request - 0x%08lX",
+			status);
+		goto exit;
+	}
+
+	WdfRequestSetCompletionRoutine(
+		SpbContext->AsyncRequest,
+		SpbAsyncReadCompletion,
+		SpbContext);
+
+	if (!WdfRequestSend(
+		SpbContext->AsyncRequest,
+		SpbContext->SpbIoTarget,
+		WDF_NO_SEND_OPTIONS))
+	{
+		status = WdfRequestGetStatus(SpbContext->AsyncRequest);
+
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_SPB,
+			"Error sending Spb async request - 0x%08lX",
+			status);
+		goto exit;
+	}
+
+exit:
+
+	if (!NT_SUCCESS(status))
+	{
+		WdfWaitLockRelease(SpbContext->SpbLock);
+	}
+
+	return status;
+}
+
+NTSTATUS
+SpbWaitForAsynchronousRead(
+	IN SPB_CONTEXT* SpbContext
+)
+/*++
+
+  Routine Description:
+
+	This routine waits for the read started by SpbReadDataAsynchronously
+	and releases the SpbLock. If the controller turned out not to support
+	sequences, the read is performed here with separate transfers.
+
+  Arguments:
+
+	SpbContext - Pointer to the current device context
+
+  Return Value:
+
+	NTSTATUS Status of the read
+
+--*/
+{
+	NTSTATUS status;
+
+	KeWaitForSingleObject(
+		&SpbContext->AsyncCompleted,
+		Executive,
+		KernelMode,
+		FALSE,
+		NULL);
+
+	status = SpbContext->AsyncStatus;
+
+	if (SpbContext->SequenceUnsupported)
+	{
+		status = SpbDoWriteReadSynchronously(
+			SpbContext,
+			SpbContext->AsyncAddress,
+			NULL,
+			0,
+			SpbContext->AsyncData,
+			SpbContext->AsyncLength);
+
+		if (SpbContext->AsyncCompletion != NULL)
+		{
+			SpbContext->AsyncCompletion(
+				SpbContext,
+				status,
+				SpbContext->AsyncCompletionContext);
+		}
+	}
+
+	if (!NT_SUCCESS(status))
+	{
+		Trace(
+			TRACE_LEVEL_ERROR,
+			TRACE_SPB,
+			"Error reading from Spb asynchronously - 0x%08lX",
+			status);
+	}
+
+	SpbContext->AsyncCompletion = NULL;
+	SpbContext->AsyncCompletionContext = NULL;
+
 	WdfWaitLockRelease(SpbContext->SpbLock);
 
 	return status;
@@ -361,20 +929,43 @@ SpbTargetDeinitialize(
 	//
 	// Free any SPB_CONTEXT allocations here
 	//
-	if (SpbContext->SpbLock != NULL)
+	if (SpbContext->AsyncRequest != NULL)
 	{
-		WdfObjectDelete(SpbContext->SpbLock);
+		WdfObjectDelete(SpbContext->AsyncRequest);
+	}
+
+	if (SpbContext->AsyncMemory != NULL)
+	{
+		WdfObjectDelete(SpbContext->AsyncMemory);
 	}
 
-	if (SpbContext->ReadMemory != NULL)
+	if (SpbContext->SpbLock != NULL)
 	{
-		WdfObjectDelete(SpbContext->ReadMemory);
+		WdfObjectDelete(SpbContext->SpbLock);
 	}
 
-	if (SpbContext->WriteMemory != NULL)
+	for (ULONG i = 0; i < SPB_BUFFER_CLASS_COUNT; i++)
 	{
-		WdfObjectDelete(SpbContext->WriteMemory);
+		Trace(
+			TRACE_LEVEL_INFORMATION,
+			TRACE_SPB,
+			"Spb buffer class %d (%d bytes) - %d hits",
+			i,
+			gSpbBufferClassSizes[i],
+			SpbContext->BufferPoolHits[i]);
+
+		if (SpbContext->BufferPool[i] != NULL)
+		{
+			WdfObjectDelete(SpbContext->BufferPool[i]);
+			SpbContext->BufferPool[i] = NULL;
+		}
 	}
+
+	Trace(
+		TRACE_LEVEL_INFORMATION,
+		TRACE_SPB,
+		"Spb buffer pool - %d misses",
+		SpbContext->BufferPoolMisses);
 }
 
 NTSTATUS
@@ -472,59 +1063,84 @@ SpbTargetInitialize(
 	// Allocate some fixed-size buffers from NonPagedPool for typical
 	// Spb transaction sizes to avoid pool fragmentation in most cases
 	//
-	status = WdfMemoryCreate(
+	for (ULONG i = 0; i < SPB_BUFFER_CLASS_COUNT; i++)
+	{
+		status = WdfMemoryCreate(
+			WDF_NO_OBJECT_ATTRIBUTES,
+			NonPagedPool,
+			TOUCH_POOL_TAG,
+			gSpbBufferClassSizes[i],
+			&SpbContext->BufferPool[i],
+			NULL);
+
+		if (!NT_SUCCESS(status))
+		{
+			Trace(
+				TRACE_LEVEL_ERROR,
+				TRACE_SPB,
+				"Error allocating default memory for Spb buffer class %d - 0x%08lX",
+				i,
+				status);
+			goto exit;
+		}
+	}
+
+	//
+	// Allocate a waitlock to guard access to the default buffers
+	//
+	status = WdfWaitLockCreate(
 		WDF_NO_OBJECT_ATTRIBUTES,
-		NonPagedPool,
-		TOUCH_POOL_TAG,
-		DEFAULT_SPB_BUFFER_SIZE,
-		&SpbContext->WriteMemory,
-		NULL);
+		&SpbContext->SpbLock);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_SPB,
-			"Error allocating default memory for Spb write - 0x%08lX",
+			"Error creating Spb Waitlock - 0x%08lX",
 			status);
 		goto exit;
 	}
 
-	status = WdfMemoryCreate(
-		WDF_NO_OBJECT_ATTRIBUTES,
-		NonPagedPool,
-		TOUCH_POOL_TAG,
-		DEFAULT_SPB_BUFFER_SIZE,
-		&SpbContext->ReadMemory,
-		NULL);
+	//
+	// Preallocate the request and sequence used for asynchronous reads,
+	// they are reused for every read so the interrupt path never allocates
+	//
+	status = WdfRequestCreate(
+		&objectAttributes,
+		SpbContext->SpbIoTarget,
+		&SpbContext->AsyncRequest);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_SPB,
-			"Error allocating default memory for Spb read - 0x%08lX",
+			"Error creating Spb async request - 0x%08lX",
 			status);
 		goto exit;
 	}
 
-	//
-	// Allocate a waitlock to guard access to the default buffers
-	//
-	status = WdfWaitLockCreate(
-		WDF_NO_OBJECT_ATTRIBUTES,
-		&SpbContext->SpbLock);
+	status = WdfMemoryCreate(
+		&objectAttributes,
+		NonPagedPool,
+		TOUCH_POOL_TAG,
+		sizeof(SPB_ASYNC_SEQUENCE),
+		&SpbContext->AsyncMemory,
+		NULL);
 
 	if (!NT_SUCCESS(status))
 	{
 		Trace(
 			TRACE_LEVEL_ERROR,
 			TRACE_SPB,
-			"Error creating Spb Waitlock - 0x%08lX",
+			"Error allocating memory for Spb async sequence - 0x%08lX",
 			status);
 		goto exit;
 	}
 
+	KeInitializeEvent(&SpbContext->AsyncCompleted, NotificationEvent, FALSE);
+
 exit:
 
 	if (!NT_SUCCESS(status))
@@ -1,5 +1,5 @@
 #include <controller.h>
-#include <spb.h>
+#include <spbhelper.h>
 #include <internal.h>
 #include <touch_power\public.h>
 #include <touch_power\touch_power.h>